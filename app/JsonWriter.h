@@ -1,79 +1,219 @@
-#include <iostream>
-#include <sstream>
+#include <cstdint>
+#include <cstring>
+
+#include <string>
+#include <vector>
+
+#if defined(_WIN64) || defined(_WIN32)
+#include <io.h>
+#define STDOUT_FILENO 1
+#else
+#include <unistd.h>
+#endif
+
+#include <sequence/details/StringView.hpp>
 
 namespace json {
 
-struct JsonNull {};
+// Writes up to size bytes to fd, returns the number of bytes written or -1.
+static inline long writeFd(int fd, const char *data, size_t size) {
+#if defined(_WIN64) || defined(_WIN32)
+  return _write(fd, data, unsigned(size));
+#else
+  return ::write(fd, data, size);
+#endif
+}
 
-class JsonStreamWriter {
+// Streams JSON into a fixed size buffer which is written to a file descriptor
+// each time it fills up. Separators are handled automatically.
+//
+// eg:
+// json::Writer writer(STDOUT_FILENO);
+// writer.beginObject().key("path").value("/tmp");
+// writer.key("sizes").beginArray().value(1).value(2).endArray();
+// writer.endObject().newline();
+class Writer {
 public:
-  JsonStreamWriter() : first(true) {}
-  virtual ~JsonStreamWriter() {}
-  virtual std::string build() {
-    finish();
-    return stream.str();
-  }
+  explicit Writer(int fd, size_t capacity = 1 << 16)
+      : fd(fd), buffer(capacity), ptr(buffer.data()) {}
+  ~Writer() { flush(); }
+
+  Writer(const Writer &) = delete;
+  Writer &operator=(const Writer &) = delete;
 
-protected:
-  friend class JsonObjectStreamWriter;
-  friend class JsonArrayStreamWriter;
-  std::ostringstream stream;
-  bool first;
+  Writer &beginObject() { return open('{'); }
+  Writer &endObject() { return close('}'); }
+  Writer &beginArray() { return open('['); }
+  Writer &endArray() { return close(']'); }
 
-  template <typename T> JsonStreamWriter &operator<<(T value) {
-    stream << value;
+  Writer &key(CStringView name) {
+    separate();
+    string(name);
+    put(':');
+    afterKey = true;
     return *this;
   }
-  JsonStreamWriter &addSep() {
-    if (first) {
-      first = false;
-    } else {
-      stream << ',';
-    }
+
+  Writer &value(CStringView value) {
+    separate();
+    string(value);
     return *this;
   }
-  virtual std::ostream &finish() = 0;
-};
+  Writer &value(const char *value) { return this->value(CStringView(value)); }
+  Writer &value(const std::string &value) {
+    return this->value(CStringView(value.data(), value.size()));
+  }
+  Writer &value(bool value) {
+    separate();
+    return raw(value ? "true" : "false");
+  }
+  Writer &value(int value) {
+    separate();
+    if (value < 0) {
+      put('-');
+      return integer(uint64_t(-int64_t(value)));
+    }
+    return integer(value);
+  }
+  Writer &value(uint32_t value) {
+    separate();
+    return integer(value);
+  }
+  Writer &value(int64_t value) {
+    separate();
+    if (value < 0) {
+      put('-');
+      return integer(uint64_t(0) - uint64_t(value));
+    }
+    return integer(value);
+  }
+  Writer &value(uint64_t value) {
+    separate();
+    return integer(value);
+  }
+  Writer &null() {
+    separate();
+    return raw("null");
+  }
 
-template <> JsonStreamWriter &JsonStreamWriter::operator<<(bool value) {
-  stream << (value ? "true" : "false");
-  return *this;
-}
+  // Writes value without quotes nor escaping.
+  Writer &raw(CStringView value) {
+    reserve(value.size());
+    memcpy(ptr, value.ptr(), value.size());
+    ptr += value.size();
+    return *this;
+  }
 
-template <> JsonStreamWriter &JsonStreamWriter::operator<<(const char *string) {
-  stream << '"' << string << '"';
-  return *this;
-}
+  // Ends the current document.
+  Writer &newline() {
+    put('\n');
+    first = true;
+    return *this;
+  }
 
-template <> JsonStreamWriter &JsonStreamWriter::operator<<(JsonNull) {
-  stream << "null";
-  return *this;
-}
+  void flush() {
+    const char *data = buffer.data();
+    while (data != ptr) {
+      const auto written = writeFd(fd, data, ptr - data);
+      if (written <= 0)
+        break;
+      data += written;
+    }
+    ptr = buffer.data();
+  }
 
-class JsonObjectStreamWriter : public JsonStreamWriter {
-public:
-  JsonObjectStreamWriter() { stream << '{'; }
+private:
+  Writer &open(char c) {
+    separate();
+    put(c);
+    first = true;
+    return *this;
+  }
 
-  template <typename T>
-  JsonObjectStreamWriter &operator<<(const std::pair<const char *, T> pair) {
-    addSep() << pair.first << ':' << pair.second;
+  Writer &close(char c) {
+    put(c);
+    first = false;
     return *this;
   }
 
-protected:
-  virtual std::ostream &finish() { return stream << '}'; }
-};
+  void separate() {
+    if (afterKey)
+      afterKey = false;
+    else if (first)
+      first = false;
+    else
+      put(',');
+  }
 
-class JsonArrayStreamWriter : public JsonStreamWriter {
-public:
-  JsonArrayStreamWriter() { stream << '['; }
-  template <typename T> JsonArrayStreamWriter &operator<<(T value) {
-    addSep() << value;
-    return *this;
+  void reserve(size_t size) {
+    if (size_t(buffer.data() + buffer.size() - ptr) < size) {
+      flush();
+      if (buffer.size() < size) {
+        buffer.resize(size);
+        ptr = buffer.data();
+      }
+    }
+  }
+
+  void put(char c) {
+    reserve(1);
+    *ptr++ = c;
+  }
+
+  Writer &integer(uint64_t value) {
+    char digits[20];
+    char *end = digits + sizeof(digits), *begin = end;
+    do {
+      *--begin = '0' + value % 10;
+      value /= 10;
+    } while (value);
+    return raw(CStringView(begin, end - begin));
+  }
+
+  void string(CStringView value) {
+    static const char hex[] = "0123456789abcdef";
+    put('"');
+    const char *chunk = value.begin();
+    for (const char *itr = value.begin(); itr != value.end(); ++itr) {
+      const unsigned char c = *itr;
+      if (c >= 0x20 && c != '"' && c != '\\')
+        continue;
+      raw(CStringView(chunk, itr - chunk));
+      chunk = itr + 1;
+      char escaped[6] = {'\\', 0, 0, 0, 0, 0};
+      size_t size = 2;
+      switch (c) {
+      case '"':
+      case '\\':
+        escaped[1] = c;
+        break;
+      case '\n':
+        escaped[1] = 'n';
+        break;
+      case '\r':
+        escaped[1] = 'r';
+        break;
+      case '\t':
+        escaped[1] = 't';
+        break;
+      default:
+        escaped[1] = 'u';
+        escaped[2] = '0';
+        escaped[3] = '0';
+        escaped[4] = hex[c >> 4];
+        escaped[5] = hex[c & 0xF];
+        size = 6;
+      }
+      raw(CStringView(escaped, size));
+    }
+    raw(CStringView(chunk, value.end() - chunk));
+    put('"');
   }
 
-protected:
-  virtual std::ostream &finish() { return stream << ']'; }
+  const int fd;
+  std::vector<char> buffer;
+  char *ptr;
+  bool first = true, afterKey = false;
 };
 
 } // namespace json
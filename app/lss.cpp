@@ -1,19 +1,31 @@
 #include "JsonWriter.h"
 
 #include <cassert>
+#include <cinttypes>
 #include <cstdio>
 #include <cstdlib>
 
 #include <vector>
 #include <string>
 
+#include <sequence/BinaryIO.hpp>
+#include <sequence/Cache.hpp>
+#include <sequence/Checksum.hpp>
 #include <sequence/Parser.hpp>
+#include <sequence/Tools.hpp>
+#include <sequence/Watcher.hpp>
 #include <sequence/ItemIO.hpp>
 #include <sequence/details/StringUtils.hpp>
 
 namespace sequence {
 
-void printRegular(const Item &item) {
+// How Items are printed.
+struct OutputOptions {
+  // Set by --ranges : INDICED items frames are output as frame specs.
+  bool frameSpec = false;
+};
+
+void printRegular(const Item &item, const OutputOptions &options) {
   const auto pFilename = item.filename.c_str();
   switch (item.getType()) {
   case Item::SINGLE:
@@ -23,7 +35,10 @@ void printRegular(const Item &item) {
     printf("Invalid\n");
     break;
   case Item::INDICED:
-    printf("%s (%zu)\n", pFilename, item.indices.size());
+    if (options.frameSpec)
+      printf("%s [%s]\n", pFilename, formatFrameSpec(item.indices).c_str());
+    else
+      printf("%s (%zu)\n", pFilename, item.indices.size());
     break;
   case Item::PACKED:
     if (item.step == 1)
@@ -31,64 +46,189 @@ void printRegular(const Item &item) {
     else
       printf("%s [%d:%d]/%d\n", pFilename, item.start, item.end, item.step);
     break;
+  case Item::GRID:
+    printf("%s ", pFilename);
+    for (size_t i = 0; i < item.extents.size(); ++i)
+      printf(i ? "x[%d:%d]" : "[%d:%d]", item.extents[i].start,
+             item.extents[i].end);
+    printf("\n");
+    break;
   }
 }
 
-void printRegular(const FolderContent &result) {
+// Digests of FolderContent::files, empty unless --checksum is set.
+typedef std::vector<SequenceDigest> Digests;
+
+void printRegular(const FolderContent &result, const Digests &digests,
+                  const OutputOptions &options) {
 
   const std::string& folder = result.name;
   const size_t indexOfLastNonSlash = folder.find_last_not_of('/');
   const size_t stringNoSlashSize = indexOfLastNonSlash + 1;
-  for (const Item &item : result.files) {
+  for (size_t i = 0; i < result.files.size(); ++i) {
+    if (!digests.empty())
+      printf("%s ", digests[i].digest.toString().c_str());
+    if (!result.stats.empty())
+      printf("%12" PRIu64 " ", result.stats[i].bytes);
     printf("%.*s/", (int)(stringNoSlashSize), folder.c_str());
-    printRegular(item);
+    printRegular(result.files[i], options);
+    if (!digests.empty() && digests[i].failed > 0)
+      printf("  %zu file(s) could not be read\n", digests[i].failed);
   }
 }
 
-std::string toJson(const Item &item) {
-  json::JsonObjectStreamWriter writer;
+void toJsonFields(json::Writer &writer, const Item &item,
+                  const OutputOptions &options) {
   const auto type = item.getType();
-  writer << std::make_pair("type", getTypeString(type));
+  writer.key("type").value(getTypeString(type));
   if (type != Item::INVALID) {
-    writer << std::make_pair("filename", item.filename.c_str());
-    if (type != Item::SINGLE)
-      writer << std::make_pair("padding", (int)item.padding);
+    writer.key("filename").value(item.filename);
+    if (type != Item::SINGLE && type != Item::GRID)
+      writer.key("padding").value((int)item.padding);
     switch (type) {
-    case Item::INDICED: {
-      json::JsonArrayStreamWriter indices;
+    case Item::INDICED:
+      if (options.frameSpec) {
+        writer.key("frames").value(formatFrameSpec(item.indices));
+        break;
+      }
+      writer.key("indices").beginArray();
       for (const auto index : item.indices)
-        indices << index;
-      writer << std::make_pair("indices", indices.build());
+        writer.value(index);
+      writer.endArray();
       break;
-    }
     case Item::PACKED:
-      writer << std::make_pair("start", item.start);
-      writer << std::make_pair("end", item.end);
-      writer << std::make_pair("step", (int)item.step);
+      writer.key("start").value(item.start);
+      writer.key("end").value(item.end);
+      writer.key("step").value((int)item.step);
+      break;
+    case Item::GRID:
+      writer.key("extents").beginArray();
+      for (const Item::Extent &extent : item.extents)
+        writer.beginArray().value(extent.start).value(extent.end).endArray();
+      writer.endArray();
       break;
     default:
       break;
     }
   }
-  return writer.build();
 }
 
-void printJson(const FolderContent &result) {
-  json::JsonObjectStreamWriter writer;
-  writer << std::make_pair("path", result.name.c_str());
-  { // directories
-    json::JsonArrayStreamWriter directories;
-    for (const Item &item : result.directories)
-      directories << item.filename.c_str();
-    writer << std::make_pair("directories", directories.build());
+void toJsonFields(json::Writer &writer, const ItemStats &stats) {
+  writer.key("bytes").value(stats.bytes);
+  if (stats.files > 0) {
+    writer.key("minMtime").value(stats.minMtime);
+    writer.key("maxMtime").value(stats.maxMtime);
+    writer.key("smallestFrame").value(stats.smallestFrame);
+    writer.key("largestFrame").value(stats.largestFrame);
+  }
+  if (stats.missing > 0)
+    writer.key("missing").value(uint64_t(stats.missing));
+}
+
+void toJsonFields(json::Writer &writer, const SequenceDigest &digest) {
+  writer.key("digest").value(digest.digest.toString());
+  writer.key("frameDigests").beginArray();
+  for (const FrameDigest &frame : digest.frames) {
+    if (frame.read)
+      writer.value(frame.digest.toString());
+    else
+      writer.null();
+  }
+  writer.endArray();
+}
+
+// Outputs result.files[i] along with its stats and digest if gathered.
+void toJsonFields(json::Writer &writer, const FolderContent &result,
+                  const Digests &digests, size_t i,
+                  const OutputOptions &options) {
+  toJsonFields(writer, result.files[i], options);
+  if (!result.stats.empty())
+    toJsonFields(writer, result.stats[i]);
+  if (!digests.empty())
+    toJsonFields(writer, digests[i]);
+}
+
+void toJson(json::Writer &writer, const Item &item,
+            const OutputOptions &options) {
+  writer.beginObject();
+  toJsonFields(writer, item, options);
+  writer.endObject();
+}
+
+// One line per Item, tagged with its folder and optionally a change kind.
+void printNdjson(json::Writer &writer, const std::string &folder,
+                 const Items &items, const OutputOptions &options,
+                 const char *change = nullptr) {
+  for (const Item &item : items) {
+    writer.beginObject();
+    writer.key("path").value(folder);
+    if (change)
+      writer.key("change").value(change);
+    toJsonFields(writer, item, options);
+    writer.endObject().newline();
+  }
+}
+
+void printNdjson(json::Writer &writer, const FolderContent &result,
+                 const Digests &digests, const OutputOptions &options) {
+  for (size_t i = 0; i < result.files.size(); ++i) {
+    writer.beginObject();
+    writer.key("path").value(result.name);
+    toJsonFields(writer, result, digests, i, options);
+    writer.endObject().newline();
+  }
+}
+
+void printJson(json::Writer &writer, const FolderContent &result,
+               const Digests &digests, const OutputOptions &options) {
+  writer.beginObject();
+  writer.key("path").value(result.name);
+  writer.key("directories").beginArray();
+  for (const Item &item : result.directories)
+    writer.value(item.filename);
+  writer.endArray();
+  writer.key("items").beginArray();
+  for (size_t i = 0; i < result.files.size(); ++i) {
+    writer.beginObject();
+    toJsonFields(writer, result, digests, i, options);
+    writer.endObject();
   }
-  { // files
-    json::JsonArrayStreamWriter files;
-    for (const Item &item : result.files)
-      files << toJson(item);
-    writer << std::make_pair("items", files.build());
+  writer.endArray();
+  writer.endObject().newline();
+}
+
+void printChange(const SequenceChange &change, json::Writer *writer,
+                 bool ndjson, const OutputOptions &options) {
+  if (writer && ndjson) {
+    printNdjson(*writer, change.folder, change.removed, options, "removed");
+    printNdjson(*writer, change.folder, change.added, options, "added");
+    writer->flush();
+  } else if (writer) {
+    writer->beginObject();
+    writer->key("path").value(change.folder);
+    writer->key("removed").beginArray();
+    for (const Item &item : change.removed)
+      toJson(*writer, item, options);
+    writer->endArray();
+    writer->key("added").beginArray();
+    for (const Item &item : change.added)
+      toJson(*writer, item, options);
+    writer->endArray();
+    writer->endObject().newline();
+    writer->flush();
+  } else {
+    const std::string &folder = change.folder;
+    const size_t stringNoSlashSize = folder.find_last_not_of('/') + 1;
+    for (const Item &item : change.removed) {
+      printf("- %.*s/", (int)(stringNoSlashSize), folder.c_str());
+      printRegular(item, options);
+    }
+    for (const Item &item : change.added) {
+      printf("+ %.*s/", (int)(stringNoSlashSize), folder.c_str());
+      printRegular(item, options);
+    }
+    fflush(stdout);
   }
-  printf("%s\n", writer.build().c_str());
 }
 
 } // namespace sequence
@@ -104,12 +244,39 @@ static void printHelp() {
                      filename.
 --sort,-s            Print folder and files lexicographically sorted.
 --json,-j            Output result as a json object.
+--ndjson             Output one json object per line and per item, each folder
+                     being flushed as soon as it is parsed.
+--binary=FILE        Also write results to FILE in binary format.
+--watch,-w           Keep running and print changes as files are created,
+                     deleted or renamed (Linux only). With -r, folders created
+                     later are watched too.
+--cache=FILE         Reuse results of unchanged folders from FILE and update
+                     it.
+--ranges             Output indices as a list of ranges eg: "1-10,12-20x2".
+--include=SUFFIX     Only parse files ending with SUFFIX eg: ".exr". Can be
+                     repeated.
+--exclude=SUFFIX     Skip files and folders ending with SUFFIX eg: ".tmp". Can
+                     be repeated.
+--no-hidden          Skip files and folders starting with '.'.
+--stats              Also output the size of each item and the mtimes, smallest
+                     and largest frames of its files.
+--checksum           Also output a digest of the content of each item, files
+                     being read concurrently. json outputs also list the digest
+                     of each file.
+--grid               Report files holding every combination of several
+                     locations as a single grid item eg:
+                     "img_u#_v#.####.exr [1:4]x[1:4]x[1001:1100]".
+                     Unpadded values crossing a number of digits give one
+                     grid per width.
 --keep=              Strategy to handle ambiguous locations.
        none          flattens the set.
        first         keep first number.
        last          keep last number.
        max-variance  keep number with highest variance (default). Backups to
                      'none' if same variance.
+       fewest-items  keep number giving the fewest items and ranges. Slower,
+                     only helps with correlated numbers (eg: a frame number
+                     repeated in the name).
 )");
 }
 
@@ -121,6 +288,12 @@ int main(int argc, char **argv) {
 
   bool recursive = false;
   bool json = false;
+  bool ndjson = false;
+  bool watch = false;
+  bool checksum = false;
+  OutputOptions options;
+  string cacheFilename;
+  string binaryFilename;
   Configuration configuration;
   configuration.getPivotIndex = RETAIN_HIGHEST_VARIANCE;
 
@@ -142,6 +315,28 @@ int main(int argc, char **argv) {
       configuration.sort = true;
     else if (arg == "--json" || arg == "-j")
       json = true;
+    else if (arg == "--ndjson")
+      ndjson = true;
+    else if (arg == "--ranges")
+      options.frameSpec = true;
+    else if (arg == "--watch" || arg == "-w")
+      watch = true;
+    else if (arg.compare(0, 10, "--include=") == 0)
+      configuration.includeSuffixes.push_back(arg.substr(10));
+    else if (arg.compare(0, 10, "--exclude=") == 0)
+      configuration.excludeSuffixes.push_back(arg.substr(10));
+    else if (arg == "--no-hidden")
+      configuration.excludePrefixes.push_back(".");
+    else if (arg == "--stats")
+      configuration.gatherStats = true;
+    else if (arg == "--checksum")
+      checksum = true;
+    else if (arg == "--grid")
+      configuration.detectGrids = true;
+    else if (arg.compare(0, 9, "--binary=") == 0)
+      binaryFilename = arg.substr(9);
+    else if (arg.compare(0, 8, "--cache=") == 0)
+      cacheFilename = arg.substr(8);
     else if (arg == "--keep=none")
       configuration.getPivotIndex = RETAIN_NONE;
     else if (arg == "--keep=first")
@@ -150,6 +345,8 @@ int main(int argc, char **argv) {
       configuration.getPivotIndex = RETAIN_LAST_LOCATION;
     else if (arg == "--keep=max-variance")
       configuration.getPivotIndex = RETAIN_HIGHEST_VARIANCE;
+    else if (arg == "--keep=fewest-items")
+      configuration.getPivotIndex = RETAIN_FEWEST_ITEMS;
     else if (arg[0] == '-') {
       printf("Unknown option : %s\n", arg.c_str());
       return EXIT_FAILURE;
@@ -157,6 +354,15 @@ int main(int argc, char **argv) {
       folder = arg;
   }
 
+  ScanCache cache(configuration);
+  if (!cacheFilename.empty())
+    cache.load(cacheFilename);
+
+  BinaryWriter binary;
+
+  Watcher watcher(configuration);
+  json::Writer writer(STDOUT_FILENO);
+
   vector<string> folders;
   folders.emplace_back(folder);
 
@@ -164,7 +370,11 @@ int main(int argc, char **argv) {
     const auto current = move(folders.back());
     folders.pop_back();
 
-    auto result = parseDir(configuration, current);
+    auto result = cacheFilename.empty() ? parseDir(configuration, current)
+                                        : cache.parseDir(current);
+
+    const Digests digests =
+        checksum ? checksumItems(current, result.files) : Digests();
 
     for (const Item &item : result.directories) {
       const string &filename = item.filename;
@@ -177,11 +387,38 @@ int main(int argc, char **argv) {
           folders.push_back(concat(current , "/", filename));
       }
     }
-    if (json) {
-      printJson(result);
+    if (ndjson) {
+      printNdjson(writer, result, digests, options);
+      writer.flush();
+    } else if (json) {
+      printJson(writer, result, digests, options);
     } else {
-      printRegular(result);
+      printRegular(result, digests, options);
     }
+    if (!binaryFilename.empty())
+      binary.add(result);
+    if (watch && !watcher.watch(current, recursive))
+      fprintf(stderr, "Unable to watch : %s\n", current.c_str());
+  }
+
+  if (!binaryFilename.empty() && !binary.save(binaryFilename)) {
+    fprintf(stderr, "Unable to write binary : %s\n", binaryFilename.c_str());
+    return EXIT_FAILURE;
+  }
+
+  if (!cacheFilename.empty() && !cache.save(cacheFilename)) {
+    fprintf(stderr, "Unable to write cache : %s\n", cacheFilename.c_str());
+    return EXIT_FAILURE;
+  }
+
+  if (watch) {
+    fflush(stdout);
+    writer.flush();
+    for (;;)
+      watcher.poll(-1, [&](const SequenceChange &change) {
+        printChange(change, json || ndjson ? &writer : nullptr, ndjson,
+                    options);
+      });
   }
 
   return EXIT_SUCCESS;
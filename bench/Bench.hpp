@@ -0,0 +1,64 @@
+#ifndef BENCH_HPP_
+#define BENCH_HPP_
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+typedef std::function<void()> Benchmark;
+
+struct Registry {
+  std::vector<std::pair<std::string, Benchmark>> benchmarks;
+
+  static Registry &get() {
+    static Registry registry;
+    return registry;
+  }
+};
+
+struct Register {
+  Register(const char *name, Benchmark benchmark) {
+    Registry::get().benchmarks.emplace_back(name, std::move(benchmark));
+  }
+};
+
+// Prevents the compiler from optimizing value away.
+template <typename T> void doNotOptimize(const T &value) {
+  asm volatile("" : : "r"(&value) : "memory");
+}
+
+// Runs function iterations times and prints the average time per iteration.
+template <typename Function>
+double measure(const char *label, size_t iterations, Function function) {
+  typedef std::chrono::steady_clock Clock;
+  const auto start = Clock::now();
+  for (size_t i = 0; i < iterations; ++i)
+    function();
+  const std::chrono::duration<double, std::milli> elapsed =
+      Clock::now() - start;
+  const double average = elapsed.count() / iterations;
+  if (average < 1)
+    printf("  %-40s %12.3f us\n", label, average * 1000);
+  else
+    printf("  %-40s %12.3f ms\n", label, average);
+  return average;
+}
+
+} // namespace bench
+
+#define BENCH_CONCAT_(A, B) A##B
+#define BENCH_CONCAT(A, B) BENCH_CONCAT_(A, B)
+
+// Declares a benchmark function, run by the bench executable.
+//
+// eg: BENCHMARK(frameSpec) { bench::measure("parse", 10, [] { ... }); }
+#define BENCHMARK(NAME)                                                        \
+  static void NAME();                                                          \
+  static bench::Register BENCH_CONCAT(register_, NAME)(#NAME, NAME);           \
+  static void NAME()
+
+#endif /* BENCH_HPP_ */
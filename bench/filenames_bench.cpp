@@ -0,0 +1,35 @@
+#include "Bench.hpp"
+
+#include <sequence/Filenames.hpp>
+#include <sequence/Tools.hpp>
+#include <sequence/details/StringUtils.hpp>
+#include <sequence/details/Utils.hpp>
+
+#include <cmath>
+
+using namespace sequence;
+
+BENCHMARK(filenames) {
+  const Item item =
+      createSequence("/path/to/shot/render/beauty.#######.exr", 1, 1000000);
+  bench::measure("FilenameIterator", 10, [&] {
+    size_t size = 0;
+    for (CStringView filename : getFilenames(item))
+      size += filename.size();
+    bench::doNotOptimize(size);
+  });
+  // What SplitBucket::getBakedPattern does for each frame.
+  bench::measure("bake and concat", 3, [&] {
+    const auto pair = getPrefixAndSuffix(item.filename);
+    const size_t padding =
+        item.filename.size() - pair.first.size() - pair.second.size();
+    size_t size = 0;
+    for (Index frame = item.start; frame <= item.end; ++frame) {
+      char buffer[10];
+      StringView view(buffer, padding == 1 ? 1 + std::log10(frame) : padding);
+      details::bake(frame, view);
+      size += concat(pair.first, view, pair.second).size();
+    }
+    bench::doNotOptimize(size);
+  });
+}
@@ -0,0 +1,47 @@
+#include "Bench.hpp"
+
+#include <sequence/FrameSet.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+
+using namespace sequence;
+
+BENCHMARK(frameSet) {
+  // A 100k frames shot with a few hundred dropped frames in each pass.
+  const Index frames = 100000;
+  const auto render = [frames](int seed) {
+    std::srand(seed);
+    Indices indices;
+    for (Index frame = 1; frame <= frames; ++frame)
+      if (std::rand() % 500 != 0)
+        indices.push_back(frame);
+    return createSequence("beauty.######.exr", std::move(indices));
+  };
+  const Item expected = createSequence("beauty.######.exr", 1, frames);
+  const Item passA = render(1), passB = render(2);
+  const FrameRanges rangesA = getFrameSet(passA), rangesB = getFrameSet(passB);
+  printf("  %zu frames, %zu and %zu ranges\n", passA.indices.size(),
+         rangesA.size(), rangesB.size());
+  bench::measure("getFrameSet (INDICED)", 100,
+                 [&] { bench::doNotOptimize(getFrameSet(passA)); });
+  bench::measure("subtract (expected - present)", 1000, [&] {
+    bench::doNotOptimize(subtract(getFrameSet(expected), rangesA));
+  });
+  bench::measure("subtract (A - B)", 1000,
+                 [&] { bench::doNotOptimize(subtract(rangesA, rangesB)); });
+  bench::measure("intersect", 1000,
+                 [&] { bench::doNotOptimize(intersect(rangesA, rangesB)); });
+  bench::measure("unite", 1000,
+                 [&] { bench::doNotOptimize(unite(rangesA, rangesB)); });
+  bench::measure("getGaps", 1000,
+                 [&] { bench::doNotOptimize(getGaps(rangesA)); });
+  bench::measure("std::set_difference on indices", 100, [&] {
+    Indices difference;
+    std::set_difference(passA.indices.begin(), passA.indices.end(),
+                        passB.indices.begin(), passB.indices.end(),
+                        std::back_inserter(difference));
+    bench::doNotOptimize(difference);
+  });
+}
@@ -0,0 +1,70 @@
+#include "Bench.hpp"
+
+#include <sequence/Tools.hpp>
+
+#include <cstdlib>
+#include <sstream>
+
+using namespace sequence;
+
+namespace {
+
+// A million frames with holes, as rendered by an unreliable farm.
+Indices getFragmentedFrames() {
+  std::srand(0);
+  Indices indices;
+  Index frame = 0;
+  while (indices.size() < 1000000) {
+    frame += std::rand() % 16 == 0 ? 2 + std::rand() % 3 : 1;
+    indices.push_back(frame);
+  }
+  return indices;
+}
+
+// Reference implementation going through std::istringstream.
+Indices parseWithStream(const std::string &spec) {
+  Indices indices;
+  std::istringstream stream(spec);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    unsigned long start = 0, end = 0, step = 1;
+    const int read = sscanf(range.c_str(), "%lu-%lux%lu", &start, &end, &step);
+    if (read < 2)
+      end = start;
+    for (unsigned long i = start; i <= end; i += step)
+      indices.push_back(Index(i));
+  }
+  return indices;
+}
+
+} // namespace
+
+BENCHMARK(frameSpec) {
+  const Indices indices = getFragmentedFrames();
+  const std::string spec = formatFrameSpec(indices);
+  const FrameRanges ranges = parseFrameRanges(spec);
+  printf("  %zu frames, %zu ranges, %zu bytes spec\n", indices.size(),
+         ranges.size(), spec.size());
+  if (parseFrameSpec(spec) != indices || parseWithStream(spec) != indices) {
+    printf("  round trip failed\n");
+    exit(EXIT_FAILURE);
+  }
+  bench::measure("parse (count only)", 20, [&spec] {
+    size_t count = 0;
+    parseFrameSpec(spec, [&count](const FrameRange &) { ++count; });
+    bench::doNotOptimize(count);
+  });
+  bench::measure("parseFrameRanges", 20, [&spec] {
+    bench::doNotOptimize(parseFrameRanges(spec));
+  });
+  bench::measure("parseFrameSpec", 20,
+                 [&spec] { bench::doNotOptimize(parseFrameSpec(spec)); });
+  bench::measure("istringstream + sscanf", 20,
+                 [&spec] { bench::doNotOptimize(parseWithStream(spec)); });
+  bench::measure("formatFrameSpec", 20, [&indices] {
+    bench::doNotOptimize(formatFrameSpec(indices));
+  });
+  bench::measure("formatFrameRanges", 20, [&ranges] {
+    bench::doNotOptimize(formatFrameRanges(ranges));
+  });
+}
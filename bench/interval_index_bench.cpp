@@ -0,0 +1,68 @@
+#include "Bench.hpp"
+
+#include <sequence/IntervalIndex.hpp>
+#include <sequence/Tools.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+using namespace sequence;
+
+namespace {
+
+bool hasFrames(const Item &item, Index start, Index end) {
+  switch (item.getType()) {
+  case Item::PACKED:
+    return item.start <= end && item.end >= start;
+  case Item::INDICED: {
+    const auto itr =
+        std::lower_bound(item.indices.begin(), item.indices.end(), start);
+    return itr != item.indices.end() && *itr <= end;
+  }
+  default:
+    return false;
+  }
+}
+
+} // namespace
+
+BENCHMARK(intervalIndex) {
+  // Thousands of shots of a hundred frames each spread over a timeline.
+  std::srand(0);
+  Items items;
+  for (int i = 0; i < 20000; ++i) {
+    const std::string pattern = "shot" + std::to_string(i) + ".####.exr";
+    const Index start = 1001 + std::rand() % 100000;
+    if (i % 4) {
+      items.push_back(createSequence(pattern, start, start + 100));
+    } else {
+      Indices indices;
+      for (Index frame = start; frame <= start + 100; ++frame)
+        if (frame % 17)
+          indices.push_back(frame);
+      items.push_back(createSequence(pattern, std::move(indices)));
+    }
+  }
+  const IntervalIndex index(items);
+  printf("  %zu items, %zu ranges\n", items.size(), index.size());
+  bench::measure("build", 10,
+                 [&] { bench::doNotOptimize(IntervalIndex(items)); });
+  std::vector<size_t> found;
+  const double indexTime = bench::measure("overlap 1001-1050", 10000, [&] {
+    index.overlap(1001, 1050, found);
+    bench::doNotOptimize(found);
+  });
+  const double scanTime = bench::measure("linear scan 1001-1050", 100, [&] {
+    found.clear();
+    for (size_t i = 0; i < items.size(); ++i)
+      if (hasFrames(items[i], 1001, 1050))
+        found.push_back(i);
+    bench::doNotOptimize(found);
+  });
+  printf("  %-40s %12.1fx\n", "speedup", scanTime / indexTime);
+  bench::measure("stab 50000", 10000, [&] {
+    index.stab(50000, found);
+    bench::doNotOptimize(found);
+  });
+}
@@ -0,0 +1,13 @@
+#include "Bench.hpp"
+
+#include <cstring>
+
+int main(int argc, char **argv) {
+  for (const auto &benchmark : bench::Registry::get().benchmarks) {
+    if (argc > 1 && strstr(benchmark.first.c_str(), argv[1]) == nullptr)
+      continue;
+    printf("%s\n", benchmark.first.c_str());
+    benchmark.second();
+  }
+  return 0;
+}
@@ -0,0 +1,81 @@
+#include "Bench.hpp"
+
+#include <sequence/Tools.hpp>
+
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace sequence;
+
+namespace {
+
+// A million item names, as found in a large listing.
+std::vector<std::string> getFilenames() {
+  const char *extensions[] = {".exr", ".dpx", ".png", ".jpg"};
+  std::vector<std::string> filenames;
+  for (size_t i = 0; filenames.size() < 1000000; ++i)
+    filenames.push_back("shot_" + std::to_string(i % 5000) + "_comp_v" +
+                        std::to_string(i % 7) + ".####" + extensions[i % 4]);
+  return filenames;
+}
+
+} // namespace
+
+BENCHMARK(matcher) {
+  const std::vector<std::string> filenames = getFilenames();
+  const char *patterns[] = {"shot_1*.@.exr", "*comp_v3.####.*", "*.@.PNG"};
+  for (const char *pattern : patterns) {
+    for (const bool ignoreCase : {false, true}) {
+      auto flags = std::regex_constants::ECMAScript;
+      if (ignoreCase)
+        flags |= std::regex_constants::icase;
+      const std::regex regex(details::getMatcherString(pattern), flags);
+      const Matcher matcher(pattern, ignoreCase);
+      const std::string suffix =
+          std::string(pattern) + (ignoreCase ? " icase" : "");
+      const double regexTime =
+          bench::measure((suffix + " std::regex").c_str(), 1, [&] {
+            size_t count = 0;
+            for (const auto &filename : filenames)
+              count += std::regex_match(filename, regex);
+            bench::doNotOptimize(count);
+          });
+      const double matcherTime =
+          bench::measure((suffix + " Matcher").c_str(), 5, [&] {
+            size_t count = 0;
+            for (const auto &filename : filenames)
+              count += matcher(filename);
+            bench::doNotOptimize(count);
+          });
+      printf("  %-40s %12.1fx\n", "speedup", regexTime / matcherTime);
+    }
+  }
+}
+
+BENCHMARK(compiledPattern) {
+  const std::vector<std::string> filenames = getFilenames();
+  constexpr auto compiled = compilePattern("*.####.exr");
+  const Matcher matcher("*.####.exr");
+  bench::measure("*.####.exr Matcher", 5, [&] {
+    size_t count = 0;
+    for (const auto &filename : filenames)
+      count += matcher(filename);
+    bench::doNotOptimize(count);
+  });
+  bench::measure("*.####.exr compilePattern", 5, [&] {
+    size_t count = 0;
+    for (const auto &filename : filenames)
+      count += compiled(filename);
+    bench::doNotOptimize(count);
+  });
+  bench::measure("*.####.exr hand written", 5, [&] {
+    const CStringView suffix(".####.exr");
+    size_t count = 0;
+    for (const auto &filename : filenames)
+      count += filename.size() >= suffix.size() &&
+               CStringView(filename).substr(filename.size() - suffix.size()) ==
+                   suffix;
+    bench::doNotOptimize(count);
+  });
+}
@@ -0,0 +1,47 @@
+#include "Bench.hpp"
+
+#include <sequence/PatternSet.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace sequence;
+
+BENCHMARK(patternSet) {
+  // Hundreds of naming conventions, one per department and version.
+  std::vector<std::string> patterns;
+  const char *departments[] = {"comp", "lgt", "fx", "anim", "plate"};
+  const char *extensions[] = {"exr", "dpx", "png", "jpg"};
+  for (const char *department : departments)
+    for (int version = 0; version < 20; ++version)
+      for (const char *extension : extensions)
+        patterns.push_back(std::string("shot_*_") + department + "_v" +
+                           std::to_string(version) + ".####." + extension);
+  std::vector<std::string> filenames;
+  for (size_t i = 0; filenames.size() < 100000; ++i)
+    filenames.push_back("shot_" + std::to_string(i % 5000) + "_" +
+                        departments[i % 5] + "_v" + std::to_string(i % 23) +
+                        ".####." + extensions[i % 4]);
+  const PatternSet set(patterns);
+  std::vector<Matcher> matchers;
+  for (const auto &pattern : patterns)
+    matchers.emplace_back(pattern);
+  printf("  %zu patterns, %zu filenames\n", patterns.size(), filenames.size());
+  const double loopTime = bench::measure("Matcher loop", 1, [&] {
+    size_t count = 0;
+    for (const auto &filename : filenames)
+      for (const auto &matcher : matchers)
+        count += matcher(filename);
+    bench::doNotOptimize(count);
+  });
+  const double setTime = bench::measure("PatternSet", 5, [&] {
+    std::vector<size_t> matched;
+    size_t count = 0;
+    for (const auto &filename : filenames) {
+      set.match(filename, matched);
+      count += matched.size();
+    }
+    bench::doNotOptimize(count);
+  });
+  printf("  %-40s %12.1fx\n", "speedup", loopTime / setTime);
+}
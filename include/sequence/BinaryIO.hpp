@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sequence/Parser.hpp>
+
+namespace sequence {
+
+// Compact versioned binary serialization of FolderContents.
+//
+// Layout, native endianness, sections are contiguous :
+//   Header
+//   FolderRecord[folderCount]
+//   ItemRecord[itemCount]
+//   string table (deduplicated, not null terminated)
+//   indices stream
+//
+// Each folder owns directoryCount + fileCount consecutive ItemRecords starting
+// at firstItem, directories first. PACKED items only store start, end and step.
+// INDICED items store their indices as runs of consecutive values, each run
+// being two varints : the delta from the previous run last value (wrapping,
+// starting from 0) and the run length minus one. GRID items store each of
+// their extents as two varints : its start and its length minus one,
+// indexCount being the total length of the extents.
+namespace binary {
+
+enum : uint32_t { MAGIC = 0x42535346 }; // "LSSB"
+enum : uint32_t { VERSION = 2 };
+
+struct Header {
+  uint32_t magic, version, folderCount, itemCount;
+  uint64_t stringsSize, indicesSize;
+};
+
+struct FolderRecord {
+  uint32_t name, nameSize;
+  uint32_t firstItem, directoryCount, fileCount;
+};
+
+struct ItemRecord {
+  uint32_t filename, filenameSize;
+  uint32_t start, end;
+  uint32_t indices, indicesSize, indexCount;
+  int8_t padding, step;
+  uint8_t type, reserved;
+};
+
+} // namespace binary
+
+// Accumulates FolderContents and serializes them.
+//
+// eg:
+// BinaryWriter writer;
+// writer.add(parseDir(configuration, "/path/to/folder"));
+// writer.save("/path/to/result.lssb");
+struct BinaryWriter {
+  void add(const FolderContent &content);
+
+  // Returns the serialized content.
+  std::string build() const;
+
+  // Writes the serialized content to filename, returns false on error. The
+  // file is written aside then renamed : a reader mapping it never sees a
+  // partial file.
+  bool save(const std::string &filename) const;
+
+private:
+  uint32_t addString(const std::string &value);
+  void addItem(const Item &item);
+
+  std::vector<binary::FolderRecord> folders;
+  std::vector<binary::ItemRecord> items;
+  std::string strings, indices;
+  std::unordered_map<std::string, uint32_t> stringOffsets;
+};
+
+// Forward iterator decoding the indices of a serialized INDICED Item.
+struct IndexIterator {
+  typedef std::forward_iterator_tag iterator_category;
+  typedef Index value_type;
+  typedef ptrdiff_t difference_type;
+  typedef const Index *pointer;
+  typedef Index reference;
+
+  IndexIterator() = default;
+  IndexIterator(const uint8_t *ptr, uint32_t count);
+
+  Index operator*() const { return value; }
+  IndexIterator &operator++();
+  IndexIterator operator++(int) {
+    IndexIterator copy(*this);
+    ++*this;
+    return copy;
+  }
+  bool operator==(const IndexIterator &o) const {
+    return remaining == o.remaining;
+  }
+  bool operator!=(const IndexIterator &o) const { return !(*this == o); }
+
+private:
+  void readRun();
+
+  const uint8_t *ptr = nullptr;
+  uint32_t remaining = 0;
+  uint32_t run = 0;
+  Index value = 0;
+};
+
+// A zero-copy view over a serialized Item.
+// Views are valid as long as the MappedContent they come from is alive.
+struct ItemView {
+  CStringView filename;
+  Index start = -1, end = -1;
+  char padding = -1, step = -1;
+  Item::Type type = Item::INVALID;
+  uint32_t indexCount = 0;
+
+  IndexIterator indicesBegin() const {
+    return IndexIterator(indices, indexCount);
+  }
+  IndexIterator indicesEnd() const { return IndexIterator(); }
+
+  // Deserializes into an Item.
+  Item toItem() const;
+
+private:
+  friend struct MappedContent;
+  const uint8_t *indices = nullptr;
+};
+
+// A zero-copy view over a serialized FolderContent.
+struct FolderView {
+  CStringView name;
+  uint32_t directoryCount = 0, fileCount = 0;
+
+  ItemView directory(size_t index) const;
+  ItemView file(size_t index) const;
+
+  // Deserializes into a FolderContent.
+  FolderContent toFolderContent() const;
+
+private:
+  friend struct MappedContent;
+  const struct MappedContent *content = nullptr;
+  uint32_t firstItem = 0;
+};
+
+// Maps a file written by BinaryWriter and gives access to its content without
+// deserializing it.
+//
+// eg:
+// MappedContent content;
+// if (content.open("/path/to/result.lssb"))
+//   for (size_t i = 0; i < content.size(); ++i) {
+//     const FolderView folder = content[i];
+//     for (size_t j = 0; j < folder.fileCount; ++j)
+//       std::cout << folder.file(j).filename.toString() << std::endl;
+//   }
+struct MappedContent {
+  MappedContent() = default;
+  MappedContent(const MappedContent &) = delete;
+  MappedContent &operator=(const MappedContent &) = delete;
+  ~MappedContent();
+
+  // Maps and validates filename, returns false if it is missing, corrupted or
+  // of a different version.
+  bool open(const std::string &filename);
+
+  // Same as above for an in memory buffer, which must outlive this object.
+  bool open(const char *data, size_t size);
+
+  void close();
+
+  // Number of folders.
+  size_t size() const { return header.folderCount; }
+
+  FolderView operator[](size_t index) const;
+
+  ItemView item(size_t index) const;
+
+private:
+  bool validate();
+
+  binary::Header header = binary::Header();
+  const char *data = nullptr;
+  size_t dataSize = 0;
+  void *mapped = nullptr;
+  std::vector<char> buffer; // used when mmap is not available
+  const char *folders = nullptr, *items = nullptr, *strings = nullptr;
+  const uint8_t *indices = nullptr;
+};
+
+} // namespace sequence
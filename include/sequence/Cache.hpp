@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include <sequence/Parser.hpp>
+
+namespace sequence {
+
+// Identifies the state of a directory on disk.
+// Adding, removing or renaming an entry updates the directory mtime/ctime so
+// two equal stamps guarantee the same listing.
+struct DirectoryStamp {
+  uint64_t device = 0, inode = 0;
+  int64_t mtime = 0, ctime = 0; // nanoseconds since epoch
+
+  bool operator==(const DirectoryStamp &o) const {
+    return device == o.device && inode == o.inode && mtime == o.mtime &&
+           ctime == o.ctime;
+  }
+  bool operator!=(const DirectoryStamp &o) const { return !(*this == o); }
+};
+
+// Fills stamp for the given directory, returns false if it cannot be stat'ed.
+bool getDirectoryStamp(CStringView foldername, DirectoryStamp &stamp);
+
+// A persistent cache of parsed directories.
+// Directories are parsed again only if their stamp changed since they were
+// cached. The cache is bound to a Configuration : loading a cache file written
+// with a different Configuration discards it.
+//
+// eg:
+// ScanCache cache(configuration);
+// cache.load("/home/user/.lss_cache");
+// const FolderContent content = cache.parseDir("/path/to/folder");
+// cache.save("/home/user/.lss_cache");
+struct ScanCache {
+  size_t hits = 0, misses = 0;
+
+  ScanCache(const Configuration &configuration)
+      : configuration(configuration) {}
+
+  // Replaces the cache content with the one from filename.
+  // Returns false if the file is missing, corrupted or incompatible.
+  bool load(const std::string &filename);
+
+  // Writes the cache to filename, returns false on error. The file is written
+  // aside then renamed : concurrent readers never see a partial cache.
+  bool save(const std::string &filename) const;
+
+  // Returns the cached content if the directory is unchanged, parses and
+  // updates the cache otherwise.
+  FolderContent parseDir(CStringView foldername);
+
+  size_t size() const { return entries.size(); }
+
+private:
+  struct Entry {
+    DirectoryStamp stamp;
+    FolderContent content;
+  };
+
+  Configuration configuration;
+  std::unordered_map<std::string, Entry> entries;
+};
+
+} // namespace sequence
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <sequence/Item.hpp>
+
+namespace sequence {
+
+// A 128 bits content digest. It detects corruption and accidental changes but
+// is not cryptographic.
+struct Digest {
+  uint64_t low = 0, high = 0;
+
+  bool operator==(const Digest &o) const {
+    return low == o.low && high == o.high;
+  }
+  bool operator!=(const Digest &o) const { return !(*this == o); }
+
+  // Returns the 32 characters hexadecimal representation.
+  std::string toString() const;
+};
+
+// Digest of a file of a sequence, read is false if it could not be read.
+struct FrameDigest {
+  Index frame;
+  Digest digest;
+  bool read;
+};
+
+// Digests of the files of an Item in filename order and their combination.
+// digest combines the frames and digests of the files that were read, it is
+// only meaningful if failed is zero.
+struct SequenceDigest {
+  std::vector<FrameDigest> frames;
+  Digest digest;
+  size_t failed = 0;
+};
+
+struct ChecksumOptions {
+  // Number of files read concurrently, 0 picks a count suited to the storage
+  // holding the folder : more readers for network filesystems to hide their
+  // latency.
+  size_t readers = 0;
+  // Size of the sequential reads.
+  size_t blockSize = 4 << 20;
+};
+
+// Returns digests[i] for items[i], reading their files in foldername.
+// Files are scheduled in frame order : concurrent readers work on
+// neighbouring frames, keeping the filesystem read ahead effective. Each file
+// is read sequentially by blocks of options.blockSize.
+// A file digest only depends on its content, the same file always gives the
+// same digest whatever the options.
+// Returns an empty vector if foldername cannot be accessed.
+//
+// eg: comparing a delivery with its source
+// const auto source = checksumItems("/shot/render", content.files);
+// const auto delivery = checksumItems("/delivery/shot", content.files);
+// source[0].digest == delivery[0].digest;
+std::vector<SequenceDigest>
+checksumItems(CStringView foldername, const Items &items,
+              const ChecksumOptions &options = ChecksumOptions());
+
+} // namespace sequence
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <sequence/Item.hpp>
+
+namespace sequence {
+
+// A file operation in Plan::folder.
+// RENAME moves the source file to target.
+// SYMLINK creates target as a symbolic link whose content is source.
+struct FileOperation {
+  enum Kind { RENAME, SYMLINK };
+
+  Kind kind;
+  std::string source, target;
+
+  bool operator==(const FileOperation &o) const {
+    return kind == o.kind && source == o.source && target == o.target;
+  }
+};
+
+typedef std::vector<FileOperation> FileOperations;
+
+// Operations to apply on the files of a sequence.
+// Operations of a chain run in order, each one freeing the target of the next
+// one. Chains are independent and run concurrently.
+// eg: renumbering 1-4 by +2 gives the chains
+//     {f4 -> f6, f2 -> f4} and {f3 -> f5, f1 -> f3}
+struct Plan {
+  std::string folder;
+  std::vector<FileOperations> chains;
+};
+
+// Returns the plan renaming the files of item in folder by offsetting their
+// frames, the last location of GRID Items, optionally changing their pattern
+// (eg: to change the padding).
+// Renames are ordered so a target is always free when renamed to.
+// eg: planRenumber("/shot/render", beauty.####.exr(1-5000), 1000)
+//
+// throws std::invalid_argument if a frame goes out of bounds, if the item has
+// no frames, if pattern does not have one padding per location of the item or
+// if renames form a cycle.
+Plan planRenumber(CStringView folder, const Item &item, int64_t offset,
+                  CStringView pattern = CStringView());
+
+// Returns the plan creating in folder symbolic links named after pattern
+// pointing to the files of item in sourceFolder. Frames of the links are
+// offset by offset.
+// eg: planRelink("/shot/view", "../render", beauty.#.exr(1-100), "b.####.exr")
+//     creates /shot/view/b.0001.exr -> ../render/beauty.1.exr ...
+//
+// throws std::invalid_argument if a frame goes out of bounds, if the item has
+// no frames or if pattern does not have one padding per location of the item.
+Plan planRelink(CStringView folder, CStringView sourceFolder, const Item &item,
+                CStringView pattern, int64_t offset = 0);
+
+// Returns the plan as shell commands, one per line, chain after chain. Useful
+// as a dry run.
+// eg: "mv 'f4' 'f6'\nmv 'f2' 'f4'\n..."
+std::string formatPlan(const Plan &plan);
+
+// Applies the plan, running chains concurrently. Operations never replace
+// existing files : if one fails the remaining operations of its chain are
+// skipped. Failed and skipped operations are appended to failed if not null.
+// Returns true if all the operations succeeded.
+bool executePlan(const Plan &plan, FileOperations *failed = nullptr,
+                 size_t threads = 0);
+
+} // namespace sequence
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <sequence/Item.hpp>
+
+namespace sequence {
+
+// Iterates over the filenames of an Item : the filename of a SINGLE Item, one
+// filename per frame for PACKED and INDICED Items, one per combination of
+// values for GRID Items, the last location changing first.
+// Each iterator owns a buffer holding the current filename, moving to the next
+// frame only rewrites its digits. The view returned by operator* is valid
+// until the iterator is incremented or destroyed. The Item must outlive its
+// iterators.
+//
+// eg:
+// for (CStringView filename : getFilenames(item))
+//   copy(filename);
+//
+// throws std::invalid_argument if a PACKED or INDICED Item filename does not
+// contain a single padding run, or a GRID Item filename one per extent.
+struct FilenameIterator {
+  typedef std::forward_iterator_tag iterator_category;
+  typedef CStringView value_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef const CStringView *pointer;
+  typedef CStringView reference;
+
+  FilenameIterator() = default; // end iterator
+  FilenameIterator(const Item &item);
+  // Iterates over count filenames of item starting at the first-th one, so
+  // large Items can be processed in batches.
+  FilenameIterator(const Item &item, size_t first, size_t count);
+
+  CStringView operator*() const { return CStringView(buffer); }
+
+  FilenameIterator &operator++();
+  FilenameIterator operator++(int) {
+    FilenameIterator copy(*this);
+    ++*this;
+    return copy;
+  }
+
+  bool operator==(const FilenameIterator &o) const {
+    return remaining == o.remaining;
+  }
+  bool operator!=(const FilenameIterator &o) const { return !(*this == o); }
+
+  // The frame of the current filename, the value of the last location for
+  // GRID Items, unspecified for SINGLE Items.
+  Index frame() const { return values.empty() ? 0 : values.back(); }
+
+  // The values of each location of the current filename.
+  const Indices &locations() const { return values; }
+
+private:
+  struct Placeholder {
+    size_t offset, digits, padding;
+  };
+
+  void setValue(size_t location, Index value);
+  void incrementValue(size_t location);
+
+  const Item *item = nullptr;
+  size_t remaining = 0; // filenames left including the current one
+  size_t position = 0;  // in item->indices
+  Indices values;
+  std::string buffer;
+  std::vector<Placeholder> placeholders;
+};
+
+struct Filenames {
+  const Item &item;
+
+  FilenameIterator begin() const { return FilenameIterator(item); }
+  FilenameIterator end() const { return FilenameIterator(); }
+};
+
+// Returns the filenames of item, see FilenameIterator.
+inline Filenames getFilenames(const Item &item) { return Filenames{item}; }
+
+// Returns the number of filenames of item.
+size_t countFilenames(const Item &item);
+
+} // namespace sequence
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <sequence/Item.hpp>
+#include <sequence/Tools.hpp>
+
+namespace sequence {
+
+// Set operations on the frames of sequences.
+// Frame sets are FrameRanges sorted by start whose spans do not overlap. A
+// range holds the frames start + n * step up to end, which is its last frame.
+// Operations merge the ranges linearly and never expand contiguous frames nor
+// progressions. Frames are only enumerated where two progressions of
+// different steps or phases overlap, their cost depends on the number of
+// ranges rather than the number of frames.
+//
+// eg: frames rendered in pass A but missing in pass B, each pass holding
+// several Items with the same pattern.
+// const Items a = ... // beauty.####.exr (1-100000)
+// const Items b = ... // beauty.####.exr (1-500), beauty.####.exr (502-100000)
+// subtract(getFrameSet(a, "beauty.####.exr"),
+//          getFrameSet(b, "beauty.####.exr")); // {501-501}
+
+// Returns the frames of a PACKED, INDICED or GRID Item, empty for other types.
+// Frames of a PACKED Item with a step greater than one give a single range of
+// that step. Frames of a GRID Item are the values of its last location.
+FrameRanges getFrameSet(const Item &item);
+
+// Returns the frames of all the Items of items whose filename is pattern.
+FrameRanges getFrameSet(const Items &items, CStringView pattern);
+
+// Returns the frames belonging to a or b.
+FrameRanges unite(const FrameRanges &a, const FrameRanges &b);
+
+// Returns the frames belonging to both a and b.
+FrameRanges intersect(const FrameRanges &a, const FrameRanges &b);
+
+// Returns the frames of a not belonging to b.
+FrameRanges subtract(const FrameRanges &a, const FrameRanges &b);
+
+// Returns the missing frames between the first and the last frame of a,
+// including the frames skipped by ranges with a step.
+FrameRanges getGaps(const FrameRanges &a);
+
+// Returns the number of frames in a.
+uint64_t countFrames(const FrameRanges &a);
+
+// Same as above for Items, which must share the same pattern.
+// throws std::invalid_argument if a and b filenames differ.
+FrameRanges unite(const Item &a, const Item &b);
+FrameRanges intersect(const Item &a, const Item &b);
+FrameRanges subtract(const Item &a, const Item &b);
+FrameRanges getGaps(const Item &a);
+
+// Converts a frame set back to PACKED Items, one per range. Ranges with a step
+// too large for an Item give an INDICED Item.
+Items toItems(CStringView pattern, const FrameRanges &frames);
+
+} // namespace sequence
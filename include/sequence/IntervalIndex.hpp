@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+#include <sequence/Item.hpp>
+
+namespace sequence {
+
+// Answers "which Items have frames within [start, end] ?" over many Items.
+// Frames of each Item are turned into ranges (see getFrameSet) stored in an
+// implicit interval tree : ranges sorted by start, each subtree knowing the
+// largest end it contains. Queries run in O(log n + k).
+// Items are referenced by their position : they must not be reordered while
+// the index is in use.
+//
+// eg:
+// const IntervalIndex index(content.files);
+// std::vector<size_t> found;
+// index.overlap(1001, 1050, found); // content.files[found[i]] have frames
+//                                   // between 1001 and 1050
+struct IntervalIndex {
+  IntervalIndex(const Items &items);
+
+  // Fills found with the sorted positions of the Items having at least one
+  // frame in [start, end]. found is cleared first.
+  void overlap(Index start, Index end, std::vector<size_t> &found) const;
+
+  // Same as above for a single frame.
+  void stab(Index frame, std::vector<size_t> &found) const {
+    overlap(frame, frame, found);
+  }
+
+  // Number of ranges in the index.
+  size_t size() const { return intervals.size(); }
+
+private:
+  struct Interval {
+    Index start, end;
+    Index step; // frames are start + n * step
+    size_t item;
+  };
+
+  Index build(size_t begin, size_t end);
+  void overlap(size_t begin, size_t end, Index start, Index last,
+               std::vector<size_t> &found) const;
+
+  std::vector<Interval> intervals; // sorted by start
+  std::vector<Index> maxEnds; // largest end of the subtree rooted at each mid
+};
+
+} // namespace sequence
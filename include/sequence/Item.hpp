@@ -16,13 +16,30 @@ namespace sequence {
 // - SINGLE  : it's either a single file or directory.
 // - INDICED : it's a sequence with a set of numbers attached to it.
 // - PACKED  : it's a contiguous sequence going from start to end inclusive.
+// - GRID    : it's a sequence with several locations holding every
+//             combination of their extents. eg: tiles x frames
+//             img_u#_v#.####.exr [1:4]x[1:4]x[1001:1100]
 struct Item {
-  enum Type { INVALID, SINGLE, INDICED, PACKED };
+  enum Type { INVALID, SINGLE, INDICED, PACKED, GRID };
+
+  // The values of a GRID location, from start to end inclusive.
+  struct Extent {
+    Index start, end;
+
+    bool operator==(const Extent &o) const {
+      return start == o.start && end == o.end;
+    }
+    bool operator<(const Extent &o) const {
+      return start < o.start || (start == o.start && end < o.end);
+    }
+  };
+  typedef std::vector<Extent> Extents;
 
   std::string filename;
   Index start = -1, end = -1;
   char padding = -1, step = -1;
   Indices indices;
+  Extents extents; // GRID : one per location of filename, in order.
 
   Item() = default;
   Item(const Item &other) = default;
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sequence/Item.hpp>
+
+namespace sequence {
+
+// Maps filenames back to the Items produced by parse.
+// Sequences are hashed by their padding agnostic pattern, a filename is looked
+// up once per run of digits it contains. Sequences sharing a pattern and a
+// padding are sorted by first frame, finding the one holding a frame is
+// O(log n) in their count. Frame membership is then O(1) for PACKED Items and
+// O(log n) for INDICED ones. GRID Items are not looked up.
+// Items are referenced, not copied : they must outlive the lookup and not be
+// modified.
+//
+// eg:
+// const FolderContent content = parseDir(configuration, "/shot/render");
+// const ItemLookup lookup(content.files);
+// Index frame;
+// const Item *item = lookup.findSequence("beauty.01042.exr", frame);
+// // item->filename == "beauty.#####.exr", frame == 1042
+// contains(*item, frame); // is frame 1042 on disk ?
+//
+// throws std::invalid_argument if an INDICED Item has unsorted indices.
+struct ItemLookup {
+  ItemLookup(const Items &items);
+
+  // Returns the Item filename is part of, nullptr if none.
+  const Item *find(CStringView filename) const;
+
+  // Returns the sequence filename would belong to, present or not, nullptr if
+  // none : the one holding the frame, else the last one starting before it or
+  // the first one.
+  // frame is set to the frame filename stands for.
+  const Item *findSequence(CStringView filename, Index &frame) const;
+
+private:
+  struct Sequence {
+    const Item *item;
+    Index start, end; // first and last frames
+    Index maxEnd;     // largest end of this sequence and the previous ones
+  };
+
+  // Sequences sharing a pattern and a padding, sorted by start.
+  struct Group {
+    size_t prefix, suffix; // sizes
+    unsigned char padding;
+    std::vector<Sequence> sequences;
+
+    // Returns the Item holding frame, nullptr if none. If closest is not null
+    // it is set to the last sequence starting at or before frame, nullptr if
+    // none.
+    const Item *find(Index frame, const Item **closest) const;
+  };
+
+  template <typename Callback>
+  void forEachGroup(CStringView filename, Callback callback) const;
+
+  std::unordered_map<std::string, const Item *> singles;
+  std::unordered_map<std::string, std::vector<Group>> groups;
+};
+
+// Tests if a PACKED, INDICED or GRID Item contains frame, frames of a GRID
+// Item being the values of its last location.
+bool contains(const Item &item, Index frame);
+
+} // namespace sequence
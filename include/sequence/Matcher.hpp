@@ -0,0 +1,200 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+#include "sequence/details/StringView.hpp"
+
+namespace sequence {
+
+namespace details {
+
+enum : size_t { NO_STAR = size_t(-1) };
+
+constexpr char toLower(char c) { return c >= 'A' && c <= 'Z' ? c + 32 : c; }
+
+constexpr bool isPadding(char c) { return c == '#' || c == '@'; }
+
+constexpr size_t countPadding(const char *pattern, size_t size) {
+  return size == 0 ? 0
+                   : isPadding(*pattern) + countPadding(pattern + 1, size - 1);
+}
+
+constexpr size_t findFirstStar(const char *pattern, size_t size, size_t i) {
+  return i == size ? size_t(NO_STAR)
+                   : pattern[i] == '*' ? i
+                                       : findFirstStar(pattern, size, i + 1);
+}
+
+constexpr size_t findLastStar(const char *pattern, size_t i) {
+  return i == 0 ? size_t(NO_STAR)
+                : pattern[i - 1] == '*' ? i - 1 : findLastStar(pattern, i - 1);
+}
+
+} // namespace details
+
+// A pattern compiled into a literal type, see compilePattern and Matcher for
+// the grammar. It only refers to the pattern characters so the pattern must
+// outlive it.
+struct CompiledPattern {
+  const char *pattern;
+  size_t size;
+  size_t firstStar, lastStar; // details::NO_STAR if none
+  bool anyPadding;            // a single padding matching one or more '#'
+  bool ignoreCase;
+
+  constexpr CompiledPattern(const char *pattern, size_t size, bool ignoreCase)
+      : pattern(pattern), size(size),
+        firstStar(details::findFirstStar(pattern, size, 0)),
+        lastStar(details::findLastStar(pattern, size)),
+        anyPadding(details::countPadding(pattern, size) == 1),
+        ignoreCase(ignoreCase) {}
+
+  constexpr CompiledPattern(const char *pattern, size_t size, size_t firstStar,
+                            size_t lastStar, bool anyPadding, bool ignoreCase)
+      : pattern(pattern), size(size), firstStar(firstStar), lastStar(lastStar),
+        anyPadding(anyPadding), ignoreCase(ignoreCase) {}
+
+  inline bool operator()(CStringView candidate) const;
+
+private:
+  inline bool equals(char patternChar, char candidateChar) const;
+  inline size_t matchForward(size_t begin, size_t end, CStringView candidate,
+                             size_t pos) const;
+  inline size_t matchBackward(size_t begin, size_t end, CStringView candidate,
+                              size_t last) const;
+};
+
+// Compiles a pattern known at compile time, an invalid pattern being a
+// compilation error. Matching is inlined, with no parsing at startup.
+//
+// eg:
+// constexpr auto matcher = compilePattern("*.####.exr");
+// matcher("plate.####.exr"); // true
+template <size_t N>
+constexpr CompiledPattern compilePattern(const char (&pattern)[N],
+                                         bool ignoreCase = false) {
+  return N <= 1 ? throw std::invalid_argument("empty pattern")
+                : details::countPadding(pattern, N - 1) == 0
+                      ? throw std::invalid_argument(
+                            "pattern should contain a padding character '#' "
+                            "or '@'")
+                      : CompiledPattern(pattern, N - 1, ignoreCase);
+}
+
+// A compiled filename pattern, to be used in place of a std::regex.
+// The grammar is the one of getMatcher :
+// - '#' and '@' are padding characters matching '#' in the candidate. If the
+//   pattern contains a single padding character it matches one or more '#',
+//   otherwise each padding character matches exactly one '#'.
+// - '*' matches any run of characters, including none.
+// - all other characters match themselves, case insensitively if requested.
+//
+// Matching does not allocate and runs in O(pattern x candidate) worst case,
+// linear when the pattern contains at most two '*'.
+//
+// eg:
+// const Matcher matcher("file-@.*");
+// matcher("file-###.png"); // true
+// matcher("file.png");     // false
+//
+// throws std::invalid_argument if pattern is empty or does not contain a
+// padding character.
+struct Matcher {
+  Matcher() = default;
+  Matcher(CStringView pattern, bool ignoreCase = false);
+
+  bool operator()(CStringView candidate) const {
+    return CompiledPattern(pattern_.data(), pattern_.size(), firstStar_,
+                           lastStar_, anyPadding_, ignoreCase_)(candidate);
+  }
+
+private:
+  std::string pattern_; // lowered if ignoreCase
+  size_t firstStar_ = details::NO_STAR, lastStar_ = details::NO_STAR;
+  bool anyPadding_ = false;
+  bool ignoreCase_ = false;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool CompiledPattern::equals(char patternChar, char candidateChar) const {
+  return ignoreCase ? details::toLower(patternChar) ==
+                          details::toLower(candidateChar)
+                    : patternChar == candidateChar;
+}
+
+// Returns the end of pattern[begin, end) matched at pos in candidate or npos.
+// A padding matching one or more '#' is the only padding of the pattern, so
+// eating all the '#' is the only way for the rest of the pattern to match.
+size_t CompiledPattern::matchForward(size_t begin, size_t end,
+                                     CStringView candidate, size_t pos) const {
+  const size_t candidateSize = candidate.size();
+  for (size_t i = begin; i < end; ++i) {
+    if (pos == candidateSize)
+      return CStringView::npos;
+    const char c = pattern[i];
+    if (details::isPadding(c)) {
+      if (candidate[pos++] != '#')
+        return CStringView::npos;
+      if (anyPadding)
+        while (pos < candidateSize && candidate[pos] == '#')
+          ++pos;
+    } else if (!equals(c, candidate[pos++])) {
+      return CStringView::npos;
+    }
+  }
+  return pos;
+}
+
+// Returns the start of pattern[begin, end) matched up to last in candidate or
+// npos.
+size_t CompiledPattern::matchBackward(size_t begin, size_t end,
+                                      CStringView candidate,
+                                      size_t last) const {
+  for (size_t i = end; i > begin; --i) {
+    if (last == 0)
+      return CStringView::npos;
+    const char c = pattern[i - 1];
+    if (details::isPadding(c)) {
+      if (candidate[--last] != '#')
+        return CStringView::npos;
+      if (anyPadding)
+        while (last > 0 && candidate[last - 1] == '#')
+          --last;
+    } else if (!equals(c, candidate[--last])) {
+      return CStringView::npos;
+    }
+  }
+  return last;
+}
+
+// The parts before the first and after the last '*' are anchored. In between,
+// taking the leftmost match of each part leaves the most room for the
+// following ones.
+bool CompiledPattern::operator()(CStringView candidate) const {
+  if (firstStar == details::NO_STAR)
+    return matchForward(0, size, candidate, 0) == candidate.size();
+  size_t pos = matchForward(0, firstStar, candidate, 0);
+  if (pos == CStringView::npos)
+    return false;
+  const size_t limit =
+      matchBackward(lastStar + 1, size, candidate, candidate.size());
+  if (limit == CStringView::npos || limit < pos)
+    return false;
+  for (size_t begin = firstStar + 1; begin <= lastStar;) {
+    size_t end = begin;
+    while (pattern[end] != '*')
+      ++end;
+    size_t matched = CStringView::npos; // npos > limit
+    for (size_t start = pos; start <= limit && matched > limit; ++start)
+      matched = matchForward(begin, end, candidate, start);
+    if (matched > limit)
+      return false;
+    pos = matched;
+    begin = end + 1;
+  }
+  return true;
+}
+
+} // namespace sequence
@@ -2,8 +2,11 @@
 #define SEQUENCEPARSERTRIE_HPP_
 
 #include <functional>
+#include <string>
+#include <vector>
 
 #include <sequence/Item.hpp>
+#include <sequence/Stats.hpp>
 
 namespace sequence {
 
@@ -42,11 +45,33 @@ namespace sequence {
 //  contains 1,2,3 and the second 1,2 : the first location will be kept.
 //       file-##-02.jpg (1-3)
 //       file-01-01.jpg
+//
+// - RETAIN_FEWEST_ITEMS
+//  the location giving the fewest Items and ranges will be kept. For each
+//  location the outcome of keeping it is predicted from the values of all the
+//  locations : one Item per distinct combination of the other locations, one
+//  range per run of consecutive values within an Item. It costs a sort of the
+//  files per location, comparing their values at every location, so
+//  O(C^2 N log N) for N files with C locations, paid again on split files
+//  keeping more than one varying location. It only helps when locations are
+//  correlated, eg: a frame number repeated in the name. On independent
+//  locations, eg: img_u##_v##.####.exr for every u, v and frame, it keeps the
+//  same location as RETAIN_HIGHEST_VARIANCE at a higher cost.
+//  eg : frames numbered twice for versions 1 and 2
+//       img_v1.0001_0001.exr ... img_v1.0050_0050.exr
+//       img_v2.0001_0001.exr ... img_v2.0050_0050.exr
+//  RETAIN_HIGHEST_VARIANCE splits versions then frames, giving 100 single
+//  files. RETAIN_FEWEST_ITEMS keeps versions, giving 50 Items
+//       img_v#.0001_0001.exr (1-2) ... img_v#.0050_0050.exr (1-2)
+//
+// Custom strategies can be passed to parse and parseDir, see
+// ParserStrategies.hpp.
 enum SplitIndexStrategy {
   RETAIN_NONE,
   RETAIN_LAST_LOCATION,
   RETAIN_HIGHEST_VARIANCE,
-  RETAIN_FIRST_LOCATION
+  RETAIN_FIRST_LOCATION,
+  RETAIN_FEWEST_ITEMS
 };
 
 // A simple structure to setup the parser
@@ -56,12 +81,32 @@ struct Configuration {
   bool pack = false;
   bool bakeSingleton = false;
   bool sort = false;
+  // Filters applied on entry names before parsing.
+  // Files are kept if includeSuffixes is empty or one of them ends their name.
+  // Files and directories are dropped if they start with one of
+  // excludePrefixes or end with one of excludeSuffixes. Dropped directories
+  // are not reported, pruning recursive walks.
+  // eg: includeSuffixes = {".exr"}, excludePrefixes = {"."} keeps non hidden
+  // exr files.
+  std::vector<std::string> includeSuffixes;
+  std::vector<std::string> excludePrefixes, excludeSuffixes;
+  // parseDir also gathers the size and mtime of the files, see getItemsStats.
+  bool gatherStats = false;
+  // Files holding every combination of contiguous values in several locations
+  // are reported as a single GRID Item instead of being split.
+  // eg: img_u#_v#.####.exr [1:4]x[1:4]x[1001:1100] rather than 16 Items.
+  // Only applies when parsing a single directory, parseDirs ignores it.
+  // Grids are not merged by mergePadding : unpadded values crossing a number
+  // of digits give one grid per width.
+  // eg: u#_v#.exr [8:9]x[1:2] and u##_v#.exr [10:12]x[1:2].
+  bool detectGrids = false;
 };
 
 // Structure returned by the parser
 struct FolderContent {
   std::string name; // parsed folder name
   Items directories, files;
+  std::vector<ItemStats> stats; // stats[i] for files[i] if gatherStats is set
 };
 
 // Standard function to parse a file system directory
@@ -77,9 +122,49 @@ struct FilesystemEntry {
 
 typedef std::function<bool(FilesystemEntry &)> GetNextEntryFunction;
 
+// Tests if an entry passes the configuration filters.
+bool acceptEntry(const Configuration &config, const FilesystemEntry &entry);
+
 FolderContent parse(const Configuration &config,
                     GetNextEntryFunction getNextEntry);
 
+// Calls onEntry for each file and directory of a file system directory.
+// Returns false if the directory cannot be opened.
+bool listDir(CStringView foldername,
+             std::function<void(const FilesystemEntry &)> onEntry);
+
+// A run of frames of a merged Item that was found under a single root.
+// start and end are -1 for Items without frames (i.e. single files).
+struct Origin {
+  size_t root; // index of the root in MergedFolderContent::roots
+  Index start, end;
+
+  bool operator==(const Origin &o) const {
+    return root == o.root && start == o.start && end == o.end;
+  }
+};
+
+typedef std::vector<Origin> Origins;
+
+// Structure returned when parsing several roots as a whole.
+// origins[i] tells which roots the frames of files[i] come from.
+struct MergedFolderContent {
+  std::vector<std::string> roots;
+  Items directories, files;
+  std::vector<Origins> origins;
+};
+
+// Parses several file system directories concurrently and unions sequences
+// sharing the same pattern.
+// eg: /vol1/shot/beauty.####.exr (1-500) and /vol2/shot/beauty.####.exr
+// (501-1000) are reported as a single beauty.####.exr (1-1000) Item.
+MergedFolderContent parseDirs(const Configuration &configuration,
+                              const std::vector<std::string> &foldernames);
+
+// Same as above for custom representations, one function per root.
+MergedFolderContent parse(const Configuration &config,
+                          std::vector<GetNextEntryFunction> getNextEntries);
+
 } // namespace sequence
 
 #endif /* SEQUENCEPARSERTRIE_HPP_ */
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <sequence/Parser.hpp>
+#include <sequence/details/ParserUtils.hpp>
+
+namespace sequence {
+
+// Compile time splitting strategies.
+//
+// A strategy is a functor called for each bucket of files sharing a pattern
+// with several locations. It returns the index of the location to split the
+// bucket on, or details::LOCATION_NONE to flatten it as individual files.
+// Buckets are split recursively until a single location is left, see
+// SplitIndexStrategy for the meaning of the predefined ones.
+//
+// Passing a strategy to parse or parseDir instantiates the splitting loop for
+// it, so custom strategies need no change to the library and are inlined.
+// Configuration::getPivotIndex is ignored in this case. Watcher, SequenceIndex
+// and ScanCache take no strategy : they only split with
+// Configuration::getPivotIndex.
+//
+// eg: keeping the location holding the largest values, frame numbers being
+// usually larger than versions whatever their count. bucket.columns are in
+// the order of the locations in bucket.pattern.
+// struct RetainLargestValues {
+//   size_t operator()(const details::Bucket &bucket) const {
+//     const auto &columns = bucket.columns;
+//     size_t largest = 0;
+//     for (size_t i = 1; i < columns.size(); ++i)
+//       if (*std::max_element(columns[i].begin(), columns[i].end()) >
+//           *std::max_element(columns[largest].begin(),
+//                             columns[largest].end()))
+//         largest = i;
+//     return largest == 0 ? 1 : 0; // splits on any other location
+//   }
+// };
+// parseDir(configuration, folder, RetainLargestValues());
+
+struct RetainNone {
+  size_t operator()(const details::Bucket &bucket) const {
+    return details::retainNone(bucket);
+  }
+};
+
+struct RetainLastLocation {
+  size_t operator()(const details::Bucket &bucket) const {
+    return details::retainLast(bucket);
+  }
+};
+
+struct RetainHighestVariance {
+  size_t operator()(const details::Bucket &bucket) const {
+    return details::retainHighestVariance(bucket);
+  }
+};
+
+struct RetainFirstLocation {
+  size_t operator()(const details::Bucket &bucket) const {
+    return details::retainFirst(bucket);
+  }
+};
+
+struct RetainFewestItems {
+  size_t operator()(const details::Bucket &bucket) const {
+    return details::retainFewestItems(bucket);
+  }
+};
+
+// Calls function with the strategy matching the SplitIndexStrategy value.
+// eg: withStrategy(RETAIN_NONE, function) returns function(RetainNone())
+template <typename Function>
+auto withStrategy(SplitIndexStrategy strategy, Function function)
+    -> decltype(function(RetainNone())) {
+  switch (strategy) {
+  case RETAIN_NONE:
+    return function(RetainNone());
+  case RETAIN_LAST_LOCATION:
+    return function(RetainLastLocation());
+  case RETAIN_FIRST_LOCATION:
+    return function(RetainFirstLocation());
+  case RETAIN_FEWEST_ITEMS:
+    return function(RetainFewestItems());
+  case RETAIN_HIGHEST_VARIANCE:
+  default:
+    return function(RetainHighestVariance());
+  }
+}
+
+namespace details {
+
+// Splits all the buckets of a directory, called once per parsed directory.
+typedef std::function<SplitBuckets(Buckets)> SplitFunction;
+
+template <typename Strategy>
+SplitFunction getSplitFunction(Strategy strategy, bool detectGrids) {
+  return [strategy, detectGrids](Buckets buckets) {
+    return splitAllAndSort(strategy, std::move(buckets), detectGrids);
+  };
+}
+
+FolderContent parse(const Configuration &config,
+                    GetNextEntryFunction getNextEntry,
+                    const SplitFunction &split);
+
+FolderContent parseDir(const Configuration &configuration,
+                       CStringView foldername, const SplitFunction &split);
+
+MergedFolderContent parse(const Configuration &config,
+                          std::vector<GetNextEntryFunction> getNextEntries,
+                          const SplitFunction &split);
+
+MergedFolderContent parseDirs(const Configuration &configuration,
+                              const std::vector<std::string> &foldernames,
+                              const SplitFunction &split);
+
+} // namespace details
+
+// Same as the functions of Parser.hpp with a custom strategy.
+template <typename Strategy>
+FolderContent parse(const Configuration &config,
+                    GetNextEntryFunction getNextEntry, Strategy strategy) {
+  return details::parse(
+      config, std::move(getNextEntry),
+      details::getSplitFunction(strategy, config.detectGrids));
+}
+
+template <typename Strategy>
+FolderContent parseDir(const Configuration &configuration,
+                       CStringView foldername, Strategy strategy) {
+  return details::parseDir(
+      configuration, foldername,
+      details::getSplitFunction(strategy, configuration.detectGrids));
+}
+
+template <typename Strategy>
+MergedFolderContent parse(const Configuration &config,
+                          std::vector<GetNextEntryFunction> getNextEntries,
+                          Strategy strategy) {
+  return details::parse(config, std::move(getNextEntries),
+                        details::getSplitFunction(strategy, false));
+}
+
+template <typename Strategy>
+MergedFolderContent parseDirs(const Configuration &configuration,
+                              const std::vector<std::string> &foldernames,
+                              Strategy strategy) {
+  return details::parseDirs(configuration, foldernames,
+                            details::getSplitFunction(strategy, false));
+}
+
+} // namespace sequence
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "sequence/Item.hpp"
+#include "sequence/Matcher.hpp"
+
+namespace sequence {
+
+// Matches a candidate against many getMatcher patterns at once.
+// The longest literal of each pattern is indexed in an Aho-Corasick automaton,
+// a single pass over the candidate finds the patterns whose literal occurs and
+// only those are checked by their Matcher.
+//
+// eg:
+// const PatternSet set({"*.####.exr", "*_comp_v@.*", "plate.@.dpx"});
+// std::vector<size_t> matched;
+// set.match("shot_comp_v#.####.exr", matched); // matched = {0, 1}
+//
+// throws std::invalid_argument if one of the patterns is invalid.
+struct PatternSet {
+  PatternSet() = default;
+  PatternSet(const std::vector<std::string> &patterns, bool ignoreCase = false);
+
+  size_t size() const { return matchers_.size(); }
+
+  // Fills matched with the sorted indices of the patterns matching candidate.
+  // matched is cleared first, reuse it across calls to avoid allocations.
+  void match(CStringView candidate, std::vector<size_t> &matched) const;
+  void match(const Item &candidate, std::vector<size_t> &matched) const;
+
+  // Tests if at least one pattern matches candidate, returning as soon as one
+  // is verified.
+  bool matchAny(CStringView candidate) const;
+
+private:
+  void addLiteral(const std::string &literal, size_t pattern);
+  void build();
+
+  // Calls callback(pattern) for each pattern whose literal occurs in candidate
+  // and each unindexed pattern, stopping as soon as it returns true.
+  // Returns whether the walk was stopped.
+  template <typename Callback>
+  bool forEachCandidate(CStringView candidate, Callback callback) const;
+
+  struct Node {
+    uint32_t fail = 0;
+    std::vector<uint32_t> outputs; // patterns whose literal ends here
+  };
+
+  std::vector<Matcher> matchers_;
+  std::vector<size_t> unindexed_; // patterns without literal, always checked
+  std::array<uint8_t, 256> classes_{}; // character to class, 0 = none
+  size_t classCount_ = 1;
+  std::vector<Node> nodes_;
+  std::vector<uint32_t> transitions_; // nodes_.size() x classCount_
+  bool ignoreCase_ = false;
+};
+
+} // namespace sequence
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include <sequence/Parser.hpp>
+
+namespace sequence {
+
+// A stateful counterpart of parse : files can be added and removed one at a
+// time and Items are computed on demand.
+// Adding or removing a file costs O(log n), contiguous frames being kept as
+// ranges which are split or joined as needed. Only the sequences touched since
+// the last snapshot are computed again.
+//
+// eg:
+// SequenceIndex index(configuration);
+// index.add("file1.jpg");
+// index.add("file2.jpg");
+// index.snapshot(); // file#.jpg (1-2)
+// index.remove("file1.jpg");
+// index.snapshot(); // file1.jpg
+struct SequenceIndex {
+  SequenceIndex(const Configuration &configuration)
+      : configuration(configuration) {}
+
+  // Returns false if filename was already present.
+  bool add(CStringView filename);
+
+  // Returns false if filename was not present.
+  bool remove(CStringView filename);
+
+  bool contains(CStringView filename) const;
+
+  // Number of files.
+  size_t size() const { return fileCount; }
+
+  // Returns the current Items, sorted.
+  Items snapshot();
+
+  // Computes the sequences touched since the last call and reports how their
+  // Items changed.
+  void update(std::function<void(const Items &removed, const Items &added)>);
+
+private:
+  // Files sharing the same pattern.
+  struct Sequence {
+    // Single column : disjoint, non adjacent ranges of frames (start -> end).
+    std::map<Index, Index> ranges;
+    // Many columns : a row of indices per file.
+    std::set<Indices> rows;
+    // No column : the file itself.
+    bool present = false;
+
+    bool empty() const { return ranges.empty() && rows.empty() && !present; }
+  };
+
+  // Sequences whose patterns only differ by padding, they may be merged
+  // together so they are computed together.
+  struct Group {
+    // By pattern and number of columns : "file####.ext" can both be a file
+    // named that way and the pattern of "file0001.ext".
+    std::map<std::pair<std::string, size_t>, Sequence> sequences;
+    Items items;                               // sorted
+    bool dirty = false;
+  };
+
+  // Extracts pattern and indices from filename, returns the group key.
+  static std::string normalize(CStringView filename, std::string &pattern,
+                               Indices &indices);
+  void compute(Group &group) const;
+
+  Configuration configuration;
+  std::map<std::string, Group> groups; // by padding agnostic pattern
+  size_t fileCount = 0;
+};
+
+} // namespace sequence
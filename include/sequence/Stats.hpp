@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <sequence/Item.hpp>
+
+namespace sequence {
+
+// Disk usage and modification times of the files of an Item.
+// mtimes are nanoseconds since epoch. smallestFrame and largestFrame are the
+// frames of the smallest and largest files, a frame much smaller than the
+// others usually being a truncated one. They are unspecified for SINGLE Items
+// and hold the value of the last location for GRID Items.
+// Files that could not be stat'ed are counted in missing and otherwise ignored.
+struct ItemStats {
+  uint64_t bytes = 0;
+  int64_t minMtime = std::numeric_limits<int64_t>::max();
+  int64_t maxMtime = std::numeric_limits<int64_t>::min();
+  Index smallestFrame = 0, largestFrame = 0;
+  uint64_t smallestSize = std::numeric_limits<uint64_t>::max();
+  uint64_t largestSize = 0;
+  size_t files = 0, missing = 0;
+
+  // Accounts for a file of frame.
+  void add(Index frame, uint64_t size, int64_t mtime);
+
+  // Accounts for the files of other.
+  void merge(const ItemStats &other);
+};
+
+// Returns stats[i] for items[i], stat'ing their files in foldername.
+// Files are split in batches stat'ed concurrently, relative to a single
+// directory handle. On Linux statx is used, asking for size and mtime only.
+// Returns an empty vector if the directory cannot be opened.
+//
+// eg: du like report
+// const auto content = parseDir(configuration, "/shot/render");
+// const auto stats = getItemsStats("/shot/render", content.files);
+// stats[0].bytes; // size of all the files of content.files[0]
+std::vector<ItemStats> getItemsStats(CStringView foldername,
+                                     const Items &items);
+
+} // namespace sequence
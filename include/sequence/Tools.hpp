@@ -2,10 +2,15 @@
 #define TOOLS_HPP_
 
 #include <sequence/Item.hpp>
+#include <sequence/Matcher.hpp>
 #include <sequence/details/StringView.hpp>
 
+#include <cstdint>
+#include <limits>
 #include <regex>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace sequence {
 
@@ -50,6 +55,55 @@ Item createSequence(CStringView pattern, Index start, Index end,
 
 Item createSequence(CStringView pattern, Indices indices);
 
+// Creates a GRID Item, extents[i] being the values of the i-th padding run of
+// pattern.
+// eg: createGrid("img_u#_v#.####.exr", {{1, 4}, {1, 4}, {1001, 1100}})
+//
+// throws std::invalid_argument if pattern does not contain one padding run per
+// extent or if an extent start is greater than its end.
+Item createGrid(CStringView pattern, Item::Extents extents);
+
+// Frame specs describe a set of frames as a comma separated list of ranges,
+// each range being either a single frame, "start-end" or "start-endxstep".
+//
+// eg: "1001-1100,1105,1110-1200x2"
+struct FrameRange {
+  Index start, end, step;
+
+  FrameRange() = default;
+  FrameRange(Index start, Index end, Index step = 1)
+      : start(start), end(end), step(step) {}
+
+  bool operator==(const FrameRange &o) const {
+    return start == o.start && end == o.end && step == o.step;
+  }
+};
+
+typedef std::vector<FrameRange> FrameRanges;
+
+// Parses a frame spec, calling push(const FrameRange&) for each range.
+// Does not allocate.
+// throws std::invalid_argument if spec is malformed, a number overflows, a
+// range is decreasing or has a 0 step.
+template <typename Push> void parseFrameSpec(CStringView spec, Push push);
+
+// Parses a frame spec into its ranges.
+FrameRanges parseFrameRanges(CStringView spec);
+
+// Parses a frame spec into the frames it contains, in spec order.
+Indices parseFrameSpec(CStringView spec);
+
+// Encodes sorted indices into the shortest frame spec.
+// Its size depends on the number of ranges rather than the number of frames.
+//
+// eg: {1, 2, 3, 5, 7, 9, 10} -> "1-3,5-9x2,10"
+std::string formatFrameSpec(const Indices &sortedIndices);
+
+// Encodes ranges into a frame spec, each range using its shortest form.
+// Ranges sharing the same step as produced by a packed SplitBucket can be
+// converted with FrameRange(range.start, range.end, step).
+std::string formatFrameRanges(const FrameRanges &ranges);
+
 // Produces a matcher from a pattern string.
 // Use it with the following match function.
 //
@@ -57,12 +111,12 @@ Item createSequence(CStringView pattern, Indices indices);
 //
 // throws std::invalid_argument if string is empty or does not contain a padding
 // character ('#' or '@').
-std::regex getMatcher(CStringView pattern, bool ignoreCase = false);
+Matcher getMatcher(CStringView pattern, bool ignoreCase = false);
 
 // Tests if a particular Item matches a pattern.
 // Useful to filter a collection of Items. eg:
 //
-// const std::regex matcher = getMatcher("file-@.*");
+// const Matcher matcher = getMatcher("file-@.*");
 //
 // Items items = ...
 // // browsing items
@@ -76,12 +130,59 @@ std::regex getMatcher(CStringView pattern, bool ignoreCase = false);
 // };
 // items.erase(std::remove_if(items.begin(), items.end(), predicate),
 // items.end());
+bool match(const Matcher &matcher, const Item &candidate);
+
+// Same as above for a regular expression, eg: built from
+// details::getMatcherString. Much slower than a Matcher.
 bool match(const std::regex &matcher, const Item &candidate);
 
 namespace details {
 std::string getMatcherString(std::string pattern);
 } // namespace details
 
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename Push> void parseFrameSpec(CStringView spec, Push push) {
+  const char *ptr = spec.begin();
+  const char *const end = spec.end();
+  const auto parseIndex = [&ptr, end]() -> Index {
+    if (ptr == end || *ptr < '0' || *ptr > '9')
+      throw std::invalid_argument("frame spec : number expected");
+    uint64_t value = 0;
+    for (; ptr != end && *ptr >= '0' && *ptr <= '9'; ++ptr) {
+      value = value * 10 + (*ptr - '0');
+      if (value > std::numeric_limits<Index>::max())
+        throw std::invalid_argument("frame spec : number too large");
+    }
+    return Index(value);
+  };
+  if (ptr == end)
+    return;
+  for (;;) {
+    FrameRange range;
+    range.start = range.end = parseIndex();
+    range.step = 1;
+    if (ptr != end && *ptr == '-') {
+      ++ptr;
+      range.end = parseIndex();
+      if (range.end < range.start)
+        throw std::invalid_argument("frame spec : decreasing range");
+      if (ptr != end && *ptr == 'x') {
+        ++ptr;
+        range.step = parseIndex();
+        if (range.step == 0)
+          throw std::invalid_argument("frame spec : step must be positive");
+      }
+    }
+    push(static_cast<const FrameRange &>(range));
+    if (ptr == end)
+      return;
+    if (*ptr != ',')
+      throw std::invalid_argument("frame spec : ',' expected");
+    ++ptr;
+  }
+}
+
 } // namespace sequence
 
 #endif /* TOOLS_HPP_ */
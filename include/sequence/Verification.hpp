@@ -0,0 +1,42 @@
+#pragma once
+
+#include <sequence/Parser.hpp>
+#include <sequence/Tools.hpp>
+
+namespace sequence {
+
+// Outcome of a sequence verification.
+// missing holds the expected frames that were not found, as ranges sharing the
+// expected step. extra holds the frames found outside the expected ones, as
+// ranges of step 1.
+struct Verification {
+  FrameRanges missing, extra;
+
+  bool complete() const { return missing.empty(); }
+};
+
+// Checks which frames of range exist for pattern in a single pass over the
+// entries : files not starting with the pattern prefix or not ending with its
+// suffix are skipped without further inspection, the others set a bit in a
+// presence bitmap covering range.
+// Frames are padded with zeros up to the pattern padding, files with a
+// different padding are not part of the sequence.
+//
+// eg:
+// Verification result;
+// verifySequence("/shot/render/beauty.####.exr", FrameRange(1001, 2400),
+//                result);
+// result.missing; // {1500-1500} if beauty.1500.exr is missing
+//
+// throws std::invalid_argument if pattern does not contain a single padding
+// run or if range.start > range.end.
+Verification verifyEntries(CStringView pattern, const FrameRange &range,
+                           GetNextEntryFunction getNextEntry);
+
+// Same as above, listing the directory pattern lives in (the current directory
+// if pattern has no directory part).
+// Returns false if the directory cannot be opened.
+bool verifySequence(CStringView pattern, const FrameRange &range,
+                    Verification &output);
+
+} // namespace sequence
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <functional>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include <sequence/Parser.hpp>
+#include <sequence/SequenceIndex.hpp>
+
+namespace sequence {
+
+// Describes how the Items of a watched folder changed.
+// Items in removed are no longer valid, Items in added replace them.
+struct SequenceChange {
+  std::string folder;
+  Items removed, added;
+};
+
+typedef std::function<void(const SequenceChange &)> ChangeFunction;
+
+// Keeps parsed folders resident in SequenceIndexes and updates them as files
+// are created, deleted or renamed. Only sequences touched by an event are
+// computed again.
+// Relies on inotify, watch() always fails on other platforms.
+//
+// eg:
+// Watcher watcher(configuration);
+// watcher.watch("/path/to/render");
+// for (;;)
+//   watcher.poll(-1, [](const SequenceChange &change) { ... });
+struct Watcher {
+  Watcher(const Configuration &configuration);
+  ~Watcher();
+
+  Watcher(const Watcher &) = delete;
+  Watcher &operator=(const Watcher &) = delete;
+
+  // Parses folder and starts watching it.
+  // If recursive is set, directories later created in folder are watched the
+  // same way, their Items being reported as added. Existing subdirectories
+  // must be watched explicitly.
+  // Returns false if the folder cannot be listed or watched.
+  bool watch(const std::string &folder, bool recursive = false);
+
+  // Stops watching folder.
+  void unwatch(const std::string &folder);
+
+  // Current content of a watched folder, files are sorted.
+  FolderContent snapshot(const std::string &folder);
+
+  // Waits up to timeoutMs milliseconds (-1 for ever) for events, applies them
+  // and calls onChange once per modified folder.
+  // Returns the number of modified folders.
+  size_t poll(int timeoutMs, ChangeFunction onChange);
+
+  // File descriptor to integrate with an external event loop, -1 if not
+  // available.
+  int fd() const { return inotifyFd; }
+
+private:
+  struct Folder {
+    std::string path;
+    bool recursive = false;
+    std::set<std::string> directories;
+    SequenceIndex files;
+
+    Folder(const Configuration &configuration) : files(configuration) {}
+  };
+
+  Folder list(const std::string &path, bool &listed) const;
+  // Watches a directory created in a recursive folder and its subdirectories,
+  // reporting their Items as added.
+  size_t watchCreated(const std::string &path, ChangeFunction &onChange);
+
+  const Configuration configuration;
+  int inotifyFd = -1;
+  std::unordered_map<int, Folder> folders;        // by watch descriptor
+  std::unordered_map<std::string, int> watchers; // watch descriptor by path
+};
+
+} // namespace sequence
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <iterator>
+
 #include "sequence/Parser.hpp"
 #include "sequence/details/Utils.hpp"
 
@@ -12,22 +15,98 @@ size_t retainNone(const Bucket &bucket);
 size_t retainFirst(const Bucket &bucket);
 size_t retainLast(const Bucket &bucket);
 size_t retainHighestVariance(const Bucket &bucket);
-
-size_t getPivotIndex(const SplitIndexStrategy strategy, const Bucket &bucket);
+size_t retainFewestItems(const Bucket &bucket);
 
 // Recursively split buckets and sort the outcome.
+// getPivotIndex is called for each splittable bucket and returns the index of
+// the column to split it on or LOCATION_NONE to flatten it, see
+// ParserStrategies.hpp. Being a template parameter it inlines in the loop.
+// If detectGrids is set, buckets holding every combination of their values are
+// kept whole as GRID buckets (see getGrid) instead of being split.
+template <typename Strategy>
+SplitBuckets splitAllAndSort(Strategy getPivotIndex, Buckets splittable_buckets,
+                             bool detectGrids = false) {
+  SplitBuckets buckets;
+  const auto pusher = [&splittable_buckets](Bucket b) {
+    splittable_buckets.push_back(std::move(b));
+  };
+  // Recursively splitting buckets.
+  while (!splittable_buckets.empty()) {
+    Bucket bucket = std::move(splittable_buckets.back());
+    splittable_buckets.pop_back();
+    if (bucket.splittable()) {
+      SplitBucket grid;
+      if (detectGrids && getGrid(bucket, grid)) {
+        buckets.emplace_back(std::move(grid));
+        continue;
+      }
+      const size_t index = getPivotIndex(bucket);
+      if (index == LOCATION_NONE) {
+        bucket.flatten(pusher);
+      } else {
+        bucket.split(index, pusher);
+      }
+    } else {
+      if (bucket.single()) {
+        bucket.flatten(pusher);
+      } else {
+        buckets.emplace_back(std::move(bucket));
+      }
+    }
+  }
+  std::sort(std::begin(buckets), std::end(buckets));
+  return buckets;
+}
+
+// Same as above with a predefined strategy, selected once for all the buckets.
 SplitBuckets splitAllAndSort(const SplitIndexStrategy strategy,
-                             Buckets splittable_buckets);
+                             Buckets splittable_buckets,
+                             bool detectGrids = false);
 
 // Merges buckets with same filename but different paddings.
-// Buckets must have only one column.
+// Buckets must have only one column. Result is sorted by pattern.
 void mergeCompatiblePadding(SplitBuckets &buckets);
 
 void bakeSingleton(SplitBuckets &bucket);
 
+// A SplitBucket gathered from several roots.
+// For buckets with indices, roots[i] is the root sortedIndices[i] was found in.
+// For buckets without indices, roots lists every root holding the file.
+struct RootedSplitBucket {
+  SplitBucket bucket;
+  std::vector<size_t> roots;
+};
+
+typedef std::vector<RootedSplitBucket> RootedSplitBuckets;
+
+// Re-keys the single files of a root under the pattern of a sequence of
+// another root they belong to, or shared with single files of other roots, as
+// if the roots were split together. perRoot[i] stays sorted.
+// eg: roots {beauty.0001.exr} and {beauty.0002.exr, beauty.0003.exr}
+//     give beauty.####.exr (1) and beauty.####.exr (2-3), not beauty.0001.exr.
+void rekeySingleFiles(std::vector<SplitBuckets> &perRoot);
+
+// Unions buckets sharing the same pattern across roots.
+// perRoot[i] holds the sorted buckets (see splitAllAndSort) of root i.
+// If an index is present in several roots, the first root wins.
+// Result is sorted by pattern.
+RootedSplitBuckets unionSplitBuckets(std::vector<SplitBuckets> perRoot);
+
+// Same as mergeCompatiblePadding for buckets gathered from several roots,
+// roots following the merged indices. Buckets must hold sortedIndices.
+void mergeCompatiblePadding(RootedSplitBuckets &buckets);
+
+// Returns the runs of consecutive indices coming from the same root.
+Origins getOrigins(const RootedSplitBucket &bucket);
+
+// Returns origins restricted to [start, end].
+Origins clipOrigins(const Origins &origins, Index start, Index end);
+
 // Compares two buckets not tacking padding into account.
 // This function is a bit costly and can be improved if needed.
 bool noPaddingLess(const Bucket &a, const Bucket &b);
+// Same as above, buckets without padding being accepted.
+bool noPaddingLess(const SplitBucket &a, const SplitBucket &b);
 
 } // namespace details
 } // namespace sequence
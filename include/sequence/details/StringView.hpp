@@ -76,12 +76,16 @@ template <typename T> bool View<T>::operator<(CView other) const {
 }
 
 template <typename T> size_t View<T>::indexOf(char c) const {
+  if (empty())
+    return npos;
   const char *const ptr = (const char *)memchr(ptr_, c, size_);
   return ptr ? ptr - ptr_ : npos;
 }
 
 #ifdef _GNU_SOURCE
 template <typename T> size_t View<T>::lastIndexOf(char c) const {
+  if (empty())
+    return npos;
   const char *const ptr = (const char *)memrchr(ptr_, c, size_);
   return ptr ? ptr - ptr_ : npos;
 }
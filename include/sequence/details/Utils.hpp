@@ -72,14 +72,41 @@ void bake(StringView pattern, size_t index, Index value);
 // Complexity is O(N).
 size_t estimateDistinctIndices(const Indices &indices);
 
+// Writes content to a temporary file next to filename then renames it over
+// filename : readers see the previous file or the new one, never a partial
+// one. Returns false on error, filename being left untouched.
+bool replaceFile(const std::string &filename, const std::string &content);
+
+struct Range {
+  Index start;
+  Index end;
+
+  Range() = default;
+  Range(Index start, Index end) : start(start), end(end) {}
+
+  bool operator==(const Range &o) const {
+    return start == o.start && end == o.end;
+  }
+};
+
+typedef std::vector<Range> Ranges;
+
 // Groups all indices for a particular pattern.
 // pattern: a string with '#' in place of digits in the filename
 // e.g. "/path/to/sequence/file##_###.cr#"
 // This pattern would have three columns, each column gathers integers for its
 // placeholder.
+//
+// Single column buckets fed with increasing indices through ingest(Index) keep
+// them as ranges sharing a common step instead of storing every index. The
+// step is given by the first two indices, ranges are dropped in favor of
+// columns as soon as an index breaks the step or ranges stop compressing well.
 struct Bucket {
   std::string pattern;
   std::vector<Indices> columns;
+  Ranges ranges;
+  char step = -1; // 0 once ranges are dropped.
+  size_t rangesCount = 0;
 
   Bucket() = default;
   Bucket(Bucket &&) = default;
@@ -93,6 +120,9 @@ struct Bucket {
   // Either columns.empty() or columns.size() == indices.size().
   void ingest(const Indices &indices);
 
+  // Adds an index to a single column pattern, keeping ranges if possible.
+  void ingest(Index index);
+
   // Returns whether this pattern represents a single value.
   // i.e. many columns with a single value.
   bool single() const;
@@ -107,23 +137,14 @@ struct Bucket {
 
   // Pushes as many Buckets as there are values, baking the indices in the file.
   void flatten(std::function<void(Bucket)> push) const;
-};
-
-typedef std::vector<Bucket> Buckets;
 
-struct Range {
-  Index start;
-  Index end;
-
-  Range() = default;
-  Range(Index start, Index end) : start(start), end(end) {}
-
-  bool operator==(const Range &o) const {
-    return start == o.start && end == o.end;
-  }
+private:
+  bool ingestRange(Index value);
+  bool insertRange(Index value);
+  void dropRanges();
 };
 
-typedef std::vector<Range> Ranges;
+typedef std::vector<Bucket> Buckets;
 
 // A bucket which contains a single column.
 // It is created from a fully splitted bucket.
@@ -133,6 +154,7 @@ struct SplitBucket {
   Indices sortedIndices;
   char step = -1;
   Ranges ranges;
+  Ranges extents; // GRID : one range per placeholder of pattern.
 
   SplitBucket() = default;
   SplitBucket(SplitBucket &&) = default;
@@ -145,6 +167,8 @@ struct SplitBucket {
   bool canMerge(const SplitBucket &other) const;
   std::string getBakedPattern(Index value) const;
   void pack();
+  // Expands ranges gathered during ingestion back into sortedIndices.
+  void unpack();
   void output(bool bakeSingleton, std::function<void(Item)> push);
 
   bool operator<(const SplitBucket &other) const {
@@ -152,6 +176,12 @@ struct SplitBucket {
   }
 };
 
+// Returns whether the rows of a splittable bucket hold every combination of
+// the values of its varying columns, each column covering a contiguous range.
+// If so, fills grid with the pattern of bucket, constant columns being baked,
+// and the extents of the varying columns. At least two columns must vary.
+bool getGrid(const Bucket &bucket, SplitBucket &grid);
+
 // Returns the step of the sorted sequence or -1.
 char getStep(Indices sortedIndices);
 
@@ -0,0 +1,363 @@
+#include "sequence/BinaryIO.hpp"
+
+#include <cstring>
+#include <limits>
+
+#include <fstream>
+
+#if defined(__APPLE__) || defined(__linux)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <sequence/details/Utils.hpp>
+
+namespace sequence {
+
+using namespace binary;
+
+namespace {
+
+void writeVarint(std::string &output, uint32_t value) {
+  while (value >= 0x80) {
+    output += char((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  output += char(value);
+}
+
+uint32_t readVarint(const uint8_t *&ptr) {
+  uint32_t value = 0;
+  for (unsigned shift = 0;; shift += 7) {
+    const uint8_t byte = *ptr++;
+    value |= uint32_t(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      return value;
+  }
+}
+
+// Returns false if a varint would read past end.
+bool readVarint(const uint8_t *&ptr, const uint8_t *end, uint32_t &value) {
+  value = 0;
+  for (unsigned shift = 0; shift < 35 && ptr != end; shift += 7) {
+    const uint8_t byte = *ptr++;
+    value |= uint32_t(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+
+// Checks a stream of runs holds exactly count values within size bytes.
+bool validRuns(const uint8_t *ptr, uint32_t size, uint32_t count) {
+  const uint8_t *const end = ptr + size;
+  uint64_t values = 0;
+  uint32_t delta, run;
+  while (ptr != end) {
+    if (!readVarint(ptr, end, delta) || !readVarint(ptr, end, run))
+      return false;
+    values += uint64_t(run) + 1;
+  }
+  return values == count;
+}
+
+// Checks a stream of extents holds exactly count values within size bytes,
+// each extent ending within Index.
+bool validExtents(const uint8_t *ptr, uint32_t size, uint32_t count) {
+  const uint8_t *const end = ptr + size;
+  uint64_t values = 0;
+  uint32_t start, run;
+  while (ptr != end) {
+    if (!readVarint(ptr, end, start) || !readVarint(ptr, end, run) ||
+        uint64_t(start) + run > std::numeric_limits<Index>::max())
+      return false;
+    values += uint64_t(run) + 1;
+  }
+  return values == count;
+}
+
+template <typename T> T readRecord(const char *ptr) {
+  T record;
+  memcpy(&record, ptr, sizeof(T));
+  return record;
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+uint32_t BinaryWriter::addString(const std::string &value) {
+  const auto itr = stringOffsets.find(value);
+  if (itr != stringOffsets.end())
+    return itr->second;
+  const uint32_t offset = strings.size();
+  strings += value;
+  stringOffsets.emplace(value, offset);
+  return offset;
+}
+
+void BinaryWriter::addItem(const Item &item) {
+  ItemRecord record = ItemRecord();
+  record.filename = addString(item.filename);
+  record.filenameSize = item.filename.size();
+  record.start = item.start;
+  record.end = item.end;
+  record.padding = item.padding;
+  record.step = item.step;
+  record.type = item.getType();
+  record.indices = indices.size();
+  if (record.type == Item::GRID) {
+    // Extents are not ordered, their starts are absolute.
+    for (const Item::Extent &extent : item.extents) {
+      writeVarint(indices, extent.start);
+      writeVarint(indices, extent.end - extent.start);
+      record.indexCount += extent.end - extent.start + 1;
+    }
+    record.indicesSize = indices.size() - record.indices;
+    items.push_back(record);
+    return;
+  }
+  record.indexCount = item.indices.size();
+  const Indices &values = item.indices;
+  Index previous = 0;
+  for (size_t i = 0; i < values.size();) {
+    size_t last = i;
+    while (last + 1 < values.size() && values[last + 1] == values[last] + 1)
+      ++last;
+    writeVarint(indices, values[i] - previous);
+    writeVarint(indices, last - i);
+    previous = values[last];
+    i = last + 1;
+  }
+  record.indicesSize = indices.size() - record.indices;
+  items.push_back(record);
+}
+
+void BinaryWriter::add(const FolderContent &content) {
+  FolderRecord record;
+  record.name = addString(content.name);
+  record.nameSize = content.name.size();
+  record.firstItem = items.size();
+  record.directoryCount = content.directories.size();
+  record.fileCount = content.files.size();
+  for (const Item &item : content.directories)
+    addItem(item);
+  for (const Item &item : content.files)
+    addItem(item);
+  folders.push_back(record);
+}
+
+std::string BinaryWriter::build() const {
+  Header header;
+  header.magic = MAGIC;
+  header.version = VERSION;
+  header.folderCount = folders.size();
+  header.itemCount = items.size();
+  header.stringsSize = strings.size();
+  header.indicesSize = indices.size();
+  std::string output;
+  output.reserve(sizeof(Header) + folders.size() * sizeof(FolderRecord) +
+                 items.size() * sizeof(ItemRecord) + strings.size() +
+                 indices.size());
+  output.append(reinterpret_cast<const char *>(&header), sizeof(Header));
+  output.append(reinterpret_cast<const char *>(folders.data()),
+                folders.size() * sizeof(FolderRecord));
+  output.append(reinterpret_cast<const char *>(items.data()),
+                items.size() * sizeof(ItemRecord));
+  output += strings;
+  output += indices;
+  return output;
+}
+
+bool BinaryWriter::save(const std::string &filename) const {
+  return details::replaceFile(filename, build());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+IndexIterator::IndexIterator(const uint8_t *ptr, uint32_t count)
+    : ptr(ptr), remaining(count) {
+  if (remaining)
+    readRun();
+}
+
+void IndexIterator::readRun() {
+  value += readVarint(ptr);
+  run = readVarint(ptr);
+}
+
+IndexIterator &IndexIterator::operator++() {
+  if (--remaining) {
+    if (run) {
+      ++value;
+      --run;
+    } else {
+      readRun();
+    }
+  }
+  return *this;
+}
+
+Item ItemView::toItem() const {
+  Item item(filename);
+  item.start = start;
+  item.end = end;
+  item.padding = padding;
+  item.step = step;
+  if (type == Item::GRID) {
+    const uint8_t *ptr = indices;
+    for (uint32_t values = 0; values < indexCount;) {
+      const Index start = readVarint(ptr);
+      const Index end = start + readVarint(ptr);
+      item.extents.push_back({start, end});
+      values += end - start + 1;
+    }
+    return item;
+  }
+  item.indices.reserve(indexCount);
+  item.indices.assign(indicesBegin(), indicesEnd());
+  return item;
+}
+
+ItemView FolderView::directory(size_t index) const {
+  return content->item(firstItem + index);
+}
+
+ItemView FolderView::file(size_t index) const {
+  return content->item(firstItem + directoryCount + index);
+}
+
+FolderContent FolderView::toFolderContent() const {
+  FolderContent output;
+  output.name = name.toString();
+  for (size_t i = 0; i < directoryCount; ++i)
+    output.directories.push_back(directory(i).toItem());
+  for (size_t i = 0; i < fileCount; ++i)
+    output.files.push_back(file(i).toItem());
+  return output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MappedContent::~MappedContent() { close(); }
+
+void MappedContent::close() {
+#if defined(__APPLE__) || defined(__linux)
+  if (mapped)
+    munmap(mapped, dataSize);
+#endif
+  mapped = nullptr;
+  buffer.clear();
+  data = nullptr;
+  dataSize = 0;
+  header = Header();
+}
+
+bool MappedContent::open(const std::string &filename) {
+  close();
+#if defined(__APPLE__) || defined(__linux)
+  const int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat stats;
+  if (fstat(fd, &stats) != 0 || stats.st_size == 0) {
+    ::close(fd);
+    return false;
+  }
+  void *ptr = mmap(nullptr, stats.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (ptr == MAP_FAILED)
+    return false;
+  mapped = ptr;
+  data = static_cast<const char *>(ptr);
+  dataSize = stats.st_size;
+#else
+  std::ifstream stream(filename, std::ios::binary);
+  buffer.assign(std::istreambuf_iterator<char>(stream),
+                std::istreambuf_iterator<char>());
+  data = buffer.data();
+  dataSize = buffer.size();
+#endif
+  if (!validate()) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+bool MappedContent::open(const char *ptr, size_t size) {
+  close();
+  data = ptr;
+  dataSize = size;
+  if (!validate()) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+bool MappedContent::validate() {
+  if (dataSize < sizeof(Header))
+    return false;
+  header = readRecord<Header>(data);
+  if (header.magic != MAGIC || header.version != VERSION)
+    return false;
+  const uint64_t expected =
+      sizeof(Header) + uint64_t(header.folderCount) * sizeof(FolderRecord) +
+      uint64_t(header.itemCount) * sizeof(ItemRecord) + header.stringsSize +
+      header.indicesSize;
+  if (expected != dataSize)
+    return false;
+  folders = data + sizeof(Header);
+  items = folders + header.folderCount * sizeof(FolderRecord);
+  strings = items + header.itemCount * sizeof(ItemRecord);
+  indices = reinterpret_cast<const uint8_t *>(strings + header.stringsSize);
+  for (uint32_t i = 0; i < header.folderCount; ++i) {
+    const auto record =
+        readRecord<FolderRecord>(folders + i * sizeof(FolderRecord));
+    if (uint64_t(record.name) + record.nameSize > header.stringsSize ||
+        uint64_t(record.firstItem) + record.directoryCount + record.fileCount >
+            header.itemCount)
+      return false;
+  }
+  for (uint32_t i = 0; i < header.itemCount; ++i) {
+    const auto record = readRecord<ItemRecord>(items + i * sizeof(ItemRecord));
+    if (uint64_t(record.filename) + record.filenameSize > header.stringsSize ||
+        uint64_t(record.indices) + record.indicesSize > header.indicesSize ||
+        record.type > Item::GRID)
+      return false;
+    const auto valid = record.type == Item::GRID ? validExtents : validRuns;
+    if (!valid(indices + record.indices, record.indicesSize,
+               record.indexCount))
+      return false;
+  }
+  return true;
+}
+
+FolderView MappedContent::operator[](size_t index) const {
+  const auto record =
+      readRecord<FolderRecord>(folders + index * sizeof(FolderRecord));
+  FolderView view;
+  view.name = CStringView(strings + record.name, record.nameSize);
+  view.directoryCount = record.directoryCount;
+  view.fileCount = record.fileCount;
+  view.content = this;
+  view.firstItem = record.firstItem;
+  return view;
+}
+
+ItemView MappedContent::item(size_t index) const {
+  const auto record =
+      readRecord<ItemRecord>(items + index * sizeof(ItemRecord));
+  ItemView view;
+  view.filename = CStringView(strings + record.filename, record.filenameSize);
+  view.start = record.start;
+  view.end = record.end;
+  view.padding = record.padding;
+  view.step = record.step;
+  view.type = Item::Type(record.type);
+  view.indexCount = record.indexCount;
+  view.indices = indices + record.indices;
+  return view;
+}
+
+} // namespace sequence
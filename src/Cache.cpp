@@ -0,0 +1,252 @@
+#include "sequence/Cache.hpp"
+
+#include <ctime>
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#if defined(__APPLE__) || defined(__linux)
+#include <sys/stat.h>
+#endif
+
+#include <sequence/details/Utils.hpp>
+
+namespace sequence {
+
+namespace {
+
+enum : uint32_t { CACHE_MAGIC = 0x4353534C }; // "LSSC"
+enum : uint32_t { CACHE_VERSION = 3 };
+
+// Directories modified less than this many seconds ago are not cached : an
+// entry added within the same timestamp granularity would go unnoticed.
+enum : int64_t { RACY_SECONDS = 2 };
+
+template <typename T> void write(std::ostream &stream, const T &value) {
+  stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T> bool read(std::istream &stream, T &value) {
+  return bool(stream.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+// Returns whether count elements of at least size bytes each are left in
+// stream, so that a corrupted count does not allocate. The whole content of
+// stream is buffered, see ScanCache::load.
+bool canRead(std::istringstream &stream, uint32_t count, size_t size) {
+  const std::streamsize left = stream.rdbuf()->in_avail();
+  return left >= 0 && uint64_t(count) * size <= uint64_t(left);
+}
+
+void write(std::ostream &stream, const std::string &value) {
+  write(stream, uint32_t(value.size()));
+  stream.write(value.data(), value.size());
+}
+
+bool read(std::istringstream &stream, std::string &value) {
+  uint32_t size;
+  if (!read(stream, size) || !canRead(stream, size, 1))
+    return false;
+  value.resize(size);
+  return size == 0 || bool(stream.read(&value[0], size));
+}
+
+void write(std::ostream &stream, const Items &items) {
+  write(stream, uint32_t(items.size()));
+  for (const Item &item : items) {
+    write(stream, item.filename);
+    write(stream, item.start);
+    write(stream, item.end);
+    write(stream, item.padding);
+    write(stream, item.step);
+    write(stream, uint32_t(item.indices.size()));
+    stream.write(reinterpret_cast<const char *>(item.indices.data()),
+                 item.indices.size() * sizeof(Index));
+    write(stream, uint32_t(item.extents.size()));
+    for (const Item::Extent &extent : item.extents) {
+      write(stream, extent.start);
+      write(stream, extent.end);
+    }
+  }
+}
+
+// Smallest size of a serialized Item.
+enum : size_t {
+  ITEM_SIZE = 3 * sizeof(uint32_t) + 2 * sizeof(Index) + 2 * sizeof(char)
+};
+
+bool read(std::istringstream &stream, Items &items) {
+  uint32_t size;
+  if (!read(stream, size) || !canRead(stream, size, ITEM_SIZE))
+    return false;
+  items.resize(size);
+  for (Item &item : items) {
+    uint32_t indices;
+    if (!read(stream, item.filename) || !read(stream, item.start) ||
+        !read(stream, item.end) || !read(stream, item.padding) ||
+        !read(stream, item.step) || !read(stream, indices) ||
+        !canRead(stream, indices, sizeof(Index)))
+      return false;
+    item.indices.resize(indices);
+    if (indices &&
+        !stream.read(reinterpret_cast<char *>(item.indices.data()),
+                     indices * sizeof(Index)))
+      return false;
+    uint32_t extents;
+    if (!read(stream, extents) ||
+        !canRead(stream, extents, sizeof(Item::Extent)))
+      return false;
+    item.extents.resize(extents);
+    for (Item::Extent &extent : item.extents)
+      if (!read(stream, extent.start) || !read(stream, extent.end))
+        return false;
+  }
+  return true;
+}
+
+void write(std::ostream &stream, const std::vector<std::string> &strings) {
+  write(stream, uint32_t(strings.size()));
+  for (const auto &string : strings)
+    write(stream, string);
+}
+
+bool read(std::istringstream &stream, std::vector<std::string> &strings) {
+  uint32_t size;
+  if (!read(stream, size) || !canRead(stream, size, sizeof(uint32_t)))
+    return false;
+  strings.resize(size);
+  for (auto &string : strings)
+    if (!read(stream, string))
+      return false;
+  return true;
+}
+
+void write(std::ostream &stream, const Configuration &c) {
+  write(stream, uint32_t(c.getPivotIndex));
+  write(stream, c.mergePadding);
+  write(stream, c.pack);
+  write(stream, c.bakeSingleton);
+  write(stream, c.sort);
+  write(stream, c.detectGrids);
+  write(stream, c.includeSuffixes);
+  write(stream, c.excludePrefixes);
+  write(stream, c.excludeSuffixes);
+}
+
+bool sameConfiguration(std::istringstream &stream, const Configuration &c) {
+  uint32_t getPivotIndex;
+  Configuration read_;
+  if (!read(stream, getPivotIndex) || !read(stream, read_.mergePadding) ||
+      !read(stream, read_.pack) || !read(stream, read_.bakeSingleton) ||
+      !read(stream, read_.sort) || !read(stream, read_.detectGrids) ||
+      !read(stream, read_.includeSuffixes) ||
+      !read(stream, read_.excludePrefixes) ||
+      !read(stream, read_.excludeSuffixes))
+    return false;
+  return getPivotIndex == uint32_t(c.getPivotIndex) &&
+         read_.mergePadding == c.mergePadding && read_.pack == c.pack &&
+         read_.bakeSingleton == c.bakeSingleton && read_.sort == c.sort &&
+         read_.detectGrids == c.detectGrids &&
+         read_.includeSuffixes == c.includeSuffixes &&
+         read_.excludePrefixes == c.excludePrefixes &&
+         read_.excludeSuffixes == c.excludeSuffixes;
+}
+
+} // namespace
+
+#if defined(__APPLE__) || defined(__linux)
+bool getDirectoryStamp(CStringView foldername, DirectoryStamp &stamp) {
+  struct stat stats;
+  if (stat(foldername.toString().c_str(), &stats) != 0 ||
+      !S_ISDIR(stats.st_mode))
+    return false;
+#if defined(__APPLE__)
+  const struct timespec &mtime = stats.st_mtimespec;
+  const struct timespec &ctime = stats.st_ctimespec;
+#else
+  const struct timespec &mtime = stats.st_mtim;
+  const struct timespec &ctime = stats.st_ctim;
+#endif
+  stamp.device = stats.st_dev;
+  stamp.inode = stats.st_ino;
+  stamp.mtime = int64_t(mtime.tv_sec) * 1000000000 + mtime.tv_nsec;
+  stamp.ctime = int64_t(ctime.tv_sec) * 1000000000 + ctime.tv_nsec;
+  return true;
+}
+#else
+// No reliable stamp, directories are always parsed.
+bool getDirectoryStamp(CStringView, DirectoryStamp &) { return false; }
+#endif
+
+bool ScanCache::load(const std::string &filename) {
+  entries.clear();
+  std::ifstream file(filename, std::ios::binary);
+  // Buffered whole so sizes can be checked against the bytes left.
+  const std::string data((std::istreambuf_iterator<char>(file)),
+                         std::istreambuf_iterator<char>());
+  std::istringstream stream(data);
+  uint32_t magic, version, count;
+  if (!read(stream, magic) || magic != CACHE_MAGIC ||
+      !read(stream, version) || version != CACHE_VERSION ||
+      !sameConfiguration(stream, configuration) || !read(stream, count))
+    return false;
+  for (uint32_t i = 0; i < count; ++i) {
+    Entry entry;
+    if (!read(stream, entry.content.name) || !read(stream, entry.stamp) ||
+        !read(stream, entry.content.directories) ||
+        !read(stream, entry.content.files)) {
+      entries.clear();
+      return false;
+    }
+    const std::string key = entry.content.name;
+    entries[key] = std::move(entry);
+  }
+  return true;
+}
+
+bool ScanCache::save(const std::string &filename) const {
+  std::ostringstream stream;
+  write(stream, uint32_t(CACHE_MAGIC));
+  write(stream, uint32_t(CACHE_VERSION));
+  write(stream, configuration);
+  write(stream, uint32_t(entries.size()));
+  for (const auto &pair : entries) {
+    const Entry &entry = pair.second;
+    write(stream, entry.content.name);
+    write(stream, entry.stamp);
+    write(stream, entry.content.directories);
+    write(stream, entry.content.files);
+  }
+  return details::replaceFile(filename, stream.str());
+}
+
+FolderContent ScanCache::parseDir(CStringView foldername) {
+  const std::string key = foldername.toString();
+  DirectoryStamp stamp;
+  if (!getDirectoryStamp(foldername, stamp)) {
+    ++misses;
+    entries.erase(key);
+    return sequence::parseDir(configuration, foldername);
+  }
+  const auto itr = entries.find(key);
+  if (itr != entries.end() && itr->second.stamp == stamp) {
+    ++hits;
+    FolderContent content = itr->second.content;
+    // Files may have changed without changing the directory stamp.
+    if (configuration.gatherStats)
+      content.stats = getItemsStats(foldername, content.files);
+    return content;
+  }
+  ++misses;
+  FolderContent content = sequence::parseDir(configuration, foldername);
+  const int64_t now = int64_t(std::time(nullptr)) * 1000000000;
+  if (stamp.mtime < now - RACY_SECONDS * 1000000000) {
+    entries[key] = Entry{stamp, content};
+  } else {
+    entries.erase(key);
+  }
+  return content;
+}
+
+} // namespace sequence
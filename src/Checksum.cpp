@@ -0,0 +1,195 @@
+#include "sequence/Checksum.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <thread>
+
+#include <sys/stat.h>
+#if defined(__linux)
+#include <fcntl.h>
+#include <sys/vfs.h>
+#endif
+
+#include <sequence/Filenames.hpp>
+
+#include "MurmurHash3.h"
+
+namespace sequence {
+
+namespace {
+
+// Files are hashed by chunks of CHUNK_SIZE whatever the size of the reads, the
+// file digest being the hash of the chunks digests and the file size.
+const size_t CHUNK_SIZE = 1 << 20;
+
+// Files read by a task, small enough for readers to stay on neighbouring
+// frames.
+const size_t BATCH_SIZE = 8;
+
+Digest murmur(const void *data, size_t size) {
+  uint64_t out[2];
+  MurmurHash3_x64_128(data, int(size), 0, out);
+  Digest digest;
+  digest.low = out[0];
+  digest.high = out[1];
+  return digest;
+}
+
+void append(std::vector<char> &bytes, const void *data, size_t size) {
+  const char *const begin = static_cast<const char *>(data);
+  bytes.insert(bytes.end(), begin, begin + size);
+}
+
+void append(std::vector<char> &bytes, const Digest &digest) {
+  append(bytes, &digest.low, sizeof(digest.low));
+  append(bytes, &digest.high, sizeof(digest.high));
+}
+
+bool isDirectory(const std::string &foldername) {
+  struct stat stats;
+  return stat(foldername.c_str(), &stats) == 0 && S_ISDIR(stats.st_mode);
+}
+
+size_t getDefaultReaders(const std::string &foldername) {
+  const size_t cores = std::max(std::thread::hardware_concurrency(), 1U);
+#if defined(__linux)
+  // Network filesystems are latency bound and benefit from more requests in
+  // flight.
+  struct statfs stats;
+  if (statfs(foldername.c_str(), &stats) == 0) {
+    switch (uint32_t(stats.f_type)) {
+    case 0x6969:     // NFS
+    case 0x517B:     // SMB
+    case 0xFE534D42: // SMB2
+    case 0xFF534D42: // CIFS
+    case 0x00C36400: // CEPH
+    case 0x65735546: // FUSE
+      return cores * 4;
+    }
+  }
+#endif
+  return cores;
+}
+
+// Reads files and computes their digest, reusing its buffers.
+struct Reader {
+  std::unique_ptr<char[]> buffer; // left uninitialized
+  size_t bufferSize;
+  std::vector<char> chunks;
+
+  Reader(size_t blockSize)
+      : bufferSize(std::max(blockSize / CHUNK_SIZE, size_t(1)) * CHUNK_SIZE) {
+    buffer.reset(new char[bufferSize]);
+  }
+
+  bool read(const std::string &filename, Digest &digest) {
+    FILE *const file = fopen(filename.c_str(), "rb");
+    if (!file)
+      return false;
+    setvbuf(file, nullptr, _IONBF, 0);
+#if defined(__linux)
+    posix_fadvise(fileno(file), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    chunks.clear();
+    uint64_t size = 0;
+    size_t read;
+    do {
+      read = fread(buffer.get(), 1, bufferSize, file);
+      size += read;
+      for (size_t offset = 0; offset < read; offset += CHUNK_SIZE)
+        append(chunks,
+               murmur(buffer.get() + offset,
+                      std::min(CHUNK_SIZE, read - offset)));
+    } while (read == bufferSize);
+    const bool failed = ferror(file);
+    fclose(file);
+    if (failed)
+      return false;
+    append(chunks, &size, sizeof(size));
+    digest = murmur(chunks.data(), chunks.size());
+    return true;
+  }
+};
+
+struct Batch {
+  size_t item, first, count;
+};
+
+} // namespace
+
+std::string Digest::toString() const {
+  char buffer[33];
+  snprintf(buffer, sizeof(buffer), "%016llx%016llx", (unsigned long long)high,
+           (unsigned long long)low);
+  return buffer;
+}
+
+std::vector<SequenceDigest> checksumItems(CStringView foldername,
+                                          const Items &items,
+                                          const ChecksumOptions &options) {
+  const std::string folder = foldername.toString();
+  if (!isDirectory(folder))
+    return {};
+  std::vector<SequenceDigest> digests(items.size());
+  // Batches follow the items and their frames order.
+  std::vector<Batch> batches;
+  for (size_t i = 0; i < items.size(); ++i) {
+    const size_t count = countFilenames(items[i]);
+    digests[i].frames.resize(count);
+    for (size_t first = 0; first < count; first += BATCH_SIZE) {
+      const size_t size = std::min(BATCH_SIZE, count - first);
+      batches.push_back({i, first, size});
+    }
+  }
+  std::atomic<size_t> next(0);
+  const auto work = [&]() {
+    Reader reader(options.blockSize);
+    std::string path = folder + '/';
+    const size_t prefix = path.size();
+    for (size_t i; (i = next++) < batches.size();) {
+      const Batch &batch = batches[i];
+      FrameDigest *frame = &digests[batch.item].frames[batch.first];
+      const Item &item = items[batch.item];
+      for (auto itr = FilenameIterator(item, batch.first, batch.count);
+           itr != FilenameIterator(); ++itr, ++frame) {
+        const CStringView filename = *itr;
+        path.resize(prefix);
+        path.append(filename.begin(), filename.size());
+        frame->frame = itr.frame();
+        frame->read = reader.read(path, frame->digest);
+      }
+    }
+  };
+  const size_t readers =
+      std::min(options.readers ? options.readers : getDefaultReaders(folder),
+               batches.size());
+  std::vector<std::future<void>> futures;
+  for (size_t i = 1; i < readers; ++i)
+    futures.push_back(std::async(std::launch::async, work));
+  work();
+  for (auto &future : futures)
+    future.get();
+  // Combining frames and digests of each sequence.
+  std::vector<char> bytes;
+  for (size_t i = 0; i < items.size(); ++i) {
+    SequenceDigest &sequence = digests[i];
+    bytes.clear();
+    for (const FrameDigest &frame : sequence.frames) {
+      if (!frame.read) {
+        ++sequence.failed;
+        continue;
+      }
+      if (items[i].getType() != Item::SINGLE)
+        append(bytes, &frame.frame, sizeof(frame.frame));
+      append(bytes, frame.digest);
+    }
+    sequence.digest = murmur(bytes.data(), bytes.size());
+  }
+  return digests;
+}
+
+} // namespace sequence
@@ -0,0 +1,265 @@
+#include "sequence/FileOperations.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#if defined(_WIN64) || defined(_WIN32)
+#include <Windows.h>
+#elif defined(__APPLE__) || defined(__linux)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <sequence/Filenames.hpp>
+
+namespace sequence {
+
+namespace {
+
+Index offsetFrame(Index frame, int64_t offset) {
+  const int64_t shifted = int64_t(frame) + offset;
+  if (shifted < 0 || shifted > std::numeric_limits<Index>::max())
+    throw std::invalid_argument("Frame out of bounds");
+  return Index(shifted);
+}
+
+size_t countPlaceholders(CStringView pattern) {
+  size_t runs = 0;
+  for (size_t i = 0; i < pattern.size(); ++i)
+    if (pattern[i] == PADDING_CHAR &&
+        (i == 0 || pattern[i - 1] != PADDING_CHAR))
+      ++runs;
+  return runs;
+}
+
+// Returns item with frames offset by offset and filename set to pattern.
+Item offsetItem(const Item &item, CStringView pattern, int64_t offset) {
+  Item output = item;
+  if (!pattern.empty()) {
+    const size_t locations =
+        item.getType() == Item::GRID ? item.extents.size() : 1;
+    if (countPlaceholders(pattern) != locations)
+      throw std::invalid_argument("Pattern must have one padding per location");
+    output.filename = pattern.toString();
+  }
+  switch (item.getType()) {
+  case Item::PACKED:
+    output.start = offsetFrame(item.start, offset);
+    output.end = offsetFrame(item.end, offset);
+    break;
+  case Item::INDICED:
+    for (Index &frame : output.indices)
+      frame = offsetFrame(frame, offset);
+    break;
+  case Item::GRID: {
+    Item::Extent &frames = output.extents.back();
+    frames.start = offsetFrame(frames.start, offset);
+    frames.end = offsetFrame(frames.end, offset);
+    break;
+  }
+  default:
+    throw std::invalid_argument("Item has no frames");
+  }
+  return output;
+}
+
+// Calls callback(source, target) for the filenames of a and b in lockstep.
+template <typename Callback>
+void forEachPair(const Item &a, const Item &b, Callback callback) {
+  const FilenameIterator end;
+  for (FilenameIterator i(a), j(b); i != end && j != end; ++i, ++j)
+    callback(*i, *j);
+}
+
+// Appends text quoted for a POSIX shell.
+void appendQuoted(std::string &output, const std::string &text) {
+  output += '\'';
+  for (const char c : text) {
+    if (c == '\'')
+      output += "'\\''";
+    else
+      output += c;
+  }
+  output += '\'';
+}
+
+#if defined(_WIN64) || defined(_WIN32)
+struct Directory {
+  std::string path;
+
+  Directory(const std::string &folder) : path(folder + '\\') {}
+
+  bool opened() const { return true; }
+
+  bool apply(const FileOperation &operation) const {
+    const std::string target = path + operation.target;
+    if (operation.kind == FileOperation::RENAME)
+      return MoveFileExA((path + operation.source).c_str(), target.c_str(), 0);
+    return CreateSymbolicLinkA(target.c_str(), operation.source.c_str(), 0);
+  }
+};
+#elif defined(__APPLE__) || defined(__linux)
+// Operations are applied relative to the directory to save path lookups.
+struct Directory {
+  int fd;
+
+  Directory(const std::string &folder)
+      : fd(open(folder.c_str(), O_RDONLY | O_DIRECTORY)) {}
+  ~Directory() {
+    if (fd >= 0)
+      close(fd);
+  }
+
+  bool opened() const { return fd >= 0; }
+
+  bool apply(const FileOperation &operation) const {
+    const char *const target = operation.target.c_str();
+    if (operation.kind == FileOperation::SYMLINK)
+      return symlinkat(operation.source.c_str(), fd, target) == 0;
+#if defined(__linux) && defined(RENAME_NOREPLACE)
+    if (renameat2(fd, operation.source.c_str(), fd, target,
+                  RENAME_NOREPLACE) == 0)
+      return true;
+    // Some filesystems (eg: NFS) do not support RENAME_NOREPLACE, older
+    // kernels and libcs lack the syscall.
+    if (errno != EINVAL && errno != ENOSYS)
+      return false;
+#endif
+    // Not atomic, a file created concurrently may still be replaced.
+    struct stat stats;
+    if (fstatat(fd, target, &stats, AT_SYMLINK_NOFOLLOW) == 0)
+      return false;
+    return renameat(fd, operation.source.c_str(), fd, target) == 0;
+  }
+};
+#else
+#error "Unsupported platform"
+#endif
+
+} // namespace
+
+Plan planRenumber(CStringView folder, const Item &item, int64_t offset,
+                  CStringView pattern) {
+  const Item target = offsetItem(item, pattern, offset);
+  FileOperations renames;
+  std::unordered_map<std::string, size_t> sources;
+  forEachPair(item, target, [&](CStringView source, CStringView target) {
+    if (source == target)
+      return;
+    sources.emplace(source.toString(), renames.size());
+    renames.push_back(
+        {FileOperation::RENAME, source.toString(), target.toString()});
+  });
+  // next[i] is the rename to run after renames[i], the one targeting its
+  // source. Chains start with renames targeting a name no rename frees.
+  const size_t NONE = std::numeric_limits<size_t>::max();
+  std::vector<size_t> next(renames.size(), NONE);
+  std::vector<bool> blocked(renames.size(), false);
+  for (size_t i = 0; i < renames.size(); ++i) {
+    const auto itr = sources.find(renames[i].target);
+    if (itr != sources.end()) {
+      next[itr->second] = i;
+      blocked[i] = true;
+    }
+  }
+  Plan plan;
+  plan.folder = folder.toString();
+  size_t planned = 0;
+  for (size_t i = 0; i < renames.size(); ++i) {
+    if (blocked[i])
+      continue;
+    plan.chains.emplace_back();
+    for (size_t j = i; j != NONE; j = next[j], ++planned)
+      plan.chains.back().push_back(std::move(renames[j]));
+  }
+  if (planned != renames.size())
+    throw std::invalid_argument("Renames form a cycle");
+  return plan;
+}
+
+Plan planRelink(CStringView folder, CStringView sourceFolder, const Item &item,
+                CStringView pattern, int64_t offset) {
+  const Item target = offsetItem(item, pattern, offset);
+  std::string prefix = sourceFolder.toString();
+  if (!prefix.empty() && prefix.back() != '/')
+    prefix += '/';
+  Plan plan;
+  plan.folder = folder.toString();
+  // Links are independent, each one is its own chain.
+  forEachPair(item, target, [&](CStringView source, CStringView target) {
+    plan.chains.push_back({{FileOperation::SYMLINK,
+                            prefix + source.toString(), target.toString()}});
+  });
+  return plan;
+}
+
+std::string formatPlan(const Plan &plan) {
+  std::string output;
+  for (const FileOperations &chain : plan.chains) {
+    for (const FileOperation &operation : chain) {
+      if (operation.kind == FileOperation::RENAME) {
+        output += "mv -n ";
+        appendQuoted(output, plan.folder + '/' + operation.source);
+      } else {
+        output += "ln -s ";
+        appendQuoted(output, operation.source);
+      }
+      output += ' ';
+      appendQuoted(output, plan.folder + '/' + operation.target);
+      output += '\n';
+    }
+  }
+  return output;
+}
+
+bool executePlan(const Plan &plan, FileOperations *failed, size_t threads) {
+  const Directory directory(plan.folder);
+  std::mutex mutex;
+  std::atomic<bool> success(true);
+  const auto fail = [&](FileOperations::const_iterator begin,
+                        FileOperations::const_iterator end) {
+    success = false;
+    if (failed) {
+      std::lock_guard<std::mutex> lock(mutex);
+      failed->insert(failed->end(), begin, end);
+    }
+  };
+  if (!directory.opened()) {
+    for (const FileOperations &chain : plan.chains)
+      fail(chain.begin(), chain.end());
+    return false;
+  }
+  std::atomic<size_t> next(0);
+  const auto work = [&]() {
+    for (size_t i; (i = next++) < plan.chains.size();) {
+      const FileOperations &chain = plan.chains[i];
+      for (auto itr = chain.begin(); itr != chain.end(); ++itr) {
+        if (!directory.apply(*itr)) {
+          fail(itr, chain.end());
+          break;
+        }
+      }
+    }
+  };
+  if (threads == 0)
+    threads = std::max(std::thread::hardware_concurrency(), 1U) * 2;
+  threads = std::min(threads, plan.chains.size());
+  std::vector<std::future<void>> futures;
+  for (size_t i = 1; i < threads; ++i)
+    futures.push_back(std::async(std::launch::async, work));
+  work();
+  for (auto &future : futures)
+    future.get();
+  return success;
+}
+
+} // namespace sequence
@@ -0,0 +1,150 @@
+#include "sequence/Filenames.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace sequence {
+
+namespace {
+
+size_t countDigits(Index value) {
+  size_t digits = 1;
+  for (; value >= 10; value /= 10)
+    ++digits;
+  return digits;
+}
+
+} // namespace
+
+FilenameIterator::FilenameIterator(const Item &item)
+    : FilenameIterator(item, 0, countFilenames(item)) {}
+
+FilenameIterator::FilenameIterator(const Item &item, size_t first,
+                                   size_t count)
+    : item(&item), buffer(item.filename) {
+  const auto type = item.getType();
+  const size_t size = countFilenames(item);
+  remaining = first < size ? std::min(count, size - first) : 0;
+  if (type == Item::SINGLE || remaining == 0)
+    return;
+  const std::string &filename = item.filename;
+  for (size_t i = 0; i < filename.size(); ++i) {
+    if (filename[i] != PADDING_CHAR)
+      continue;
+    const size_t offset = i;
+    while (i < filename.size() && filename[i] == PADDING_CHAR)
+      ++i;
+    placeholders.push_back({offset, i - offset, i - offset});
+  }
+  const size_t locations = type == Item::GRID ? item.extents.size() : 1;
+  if (placeholders.size() != locations)
+    throw std::invalid_argument("Pattern must have one padding per location");
+  values.resize(locations);
+  switch (type) {
+  case Item::PACKED:
+    setValue(0, item.start + first * std::max<Index>(item.step, 1));
+    break;
+  case Item::INDICED:
+    position = first;
+    setValue(0, item.indices[first]);
+    break;
+  case Item::GRID:
+    // The last location changes first.
+    for (size_t i = locations; i-- > 0;) {
+      const Item::Extent &extent = item.extents[i];
+      const size_t size = size_t(extent.end) - extent.start + 1;
+      setValue(i, extent.start + first % size);
+      first /= size;
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+// Writes value in the placeholder of location, padded with zeros.
+void FilenameIterator::setValue(size_t location, Index value) {
+  Placeholder &placeholder = placeholders[location];
+  const size_t width = std::max(placeholder.padding, countDigits(value));
+  if (width != placeholder.digits) {
+    buffer.replace(placeholder.offset, placeholder.digits, width, '0');
+    // Following placeholders move along.
+    for (size_t i = location + 1; i < placeholders.size(); ++i)
+      placeholders[i].offset += width - placeholder.digits;
+    placeholder.digits = width;
+  }
+  values[location] = value;
+  const size_t begin = placeholder.offset;
+  for (size_t i = begin + placeholder.digits; i > begin; value /= 10)
+    buffer[--i] = '0' + value % 10;
+}
+
+// Increments the digits in place, only rewriting the placeholder when all its
+// digits are nines.
+void FilenameIterator::incrementValue(size_t location) {
+  const Placeholder &placeholder = placeholders[location];
+  const size_t begin = placeholder.offset;
+  for (size_t i = begin + placeholder.digits; i > begin;) {
+    char &digit = buffer[--i];
+    if (digit != '9') {
+      ++digit;
+      ++values[location];
+      return;
+    }
+    digit = '0';
+  }
+  setValue(location, values[location] + 1);
+}
+
+FilenameIterator &FilenameIterator::operator++() {
+  if (remaining == 0 || --remaining == 0)
+    return *this;
+  switch (item->getType()) {
+  case Item::PACKED:
+    if (item->step <= 1)
+      incrementValue(0);
+    else
+      setValue(0, values[0] + item->step);
+    break;
+  case Item::INDICED: {
+    const Index next = item->indices[++position];
+    if (next == values[0] + 1)
+      incrementValue(0);
+    else
+      setValue(0, next);
+    break;
+  }
+  case Item::GRID: {
+    size_t location = values.size() - 1;
+    // Rewinding exhausted locations, there is always a next combination.
+    for (; values[location] == item->extents[location].end; --location)
+      setValue(location, item->extents[location].start);
+    incrementValue(location);
+    break;
+  }
+  default:
+    break;
+  }
+  return *this;
+}
+
+size_t countFilenames(const Item &item) {
+  switch (item.getType()) {
+  case Item::SINGLE:
+    return 1;
+  case Item::PACKED:
+    return (item.end - item.start) / std::max<Index>(item.step, 1) + 1;
+  case Item::INDICED:
+    return item.indices.size();
+  case Item::GRID: {
+    size_t count = 1;
+    for (const Item::Extent &extent : item.extents)
+      count *= size_t(extent.end) - extent.start + 1;
+    return count;
+  }
+  default:
+    return 0;
+  }
+}
+
+} // namespace sequence
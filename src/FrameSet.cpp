@@ -0,0 +1,312 @@
+#include "sequence/FrameSet.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace sequence {
+
+namespace {
+
+// Appends the frames start + n * step up to end to output. Ranges must come by
+// increasing start. Contiguous ranges are joined, as are pieces of a same
+// progression.
+void append(FrameRanges &output, uint64_t start, uint64_t end,
+            uint64_t step = 1) {
+  if (start == end)
+    step = 1;
+  if (!output.empty()) {
+    FrameRange &last = output.back();
+    if (last.step == 1 && step == 1 && start <= uint64_t(last.end) + 1) {
+      last.end = std::max<uint64_t>(last.end, end);
+      return;
+    }
+    // Continuing a progression, or turning a single frame into one.
+    const uint64_t lastStep = last.start == last.end ? step : last.step;
+    if (lastStep > 1 && (start == end || step == lastStep) &&
+        start == last.end + lastStep) {
+      last.end = Index(end);
+      last.step = Index(lastStep);
+      return;
+    }
+  }
+  output.emplace_back(Index(start), Index(end), Index(step));
+}
+
+void appendRuns(FrameRanges &output, const Indices &sortedIndices) {
+  const Index *const data = sortedIndices.data();
+  const size_t size = sortedIndices.size();
+  for (size_t i = 0; i < size;) {
+    const Index start = data[i++];
+    // Sorted indices only differ by 0 (duplicate) or 1 within a run.
+    while (i < size && data[i] - data[i - 1] <= 1)
+      ++i;
+    output.emplace_back(start, data[i - 1]);
+  }
+}
+
+void checkSamePattern(const Item &a, const Item &b) {
+  if (a.filename != b.filename)
+    throw std::invalid_argument("Items must share the same pattern");
+}
+
+// The frames of a range within a segment, step being the one of the range :
+// a range of step 1 covers the whole segment.
+struct Piece {
+  bool empty = true;
+  uint64_t start = 0, end = 0, step = 1;
+
+  bool contains(uint64_t frame) const {
+    return !empty && frame >= start && frame <= end &&
+           (frame - start) % step == 0;
+  }
+};
+
+Piece clip(const FrameRange &range, uint64_t first, uint64_t last) {
+  Piece piece;
+  const uint64_t step = range.step > 1 ? range.step : 1;
+  uint64_t start = range.start;
+  if (start < first)
+    start += (first - start + step - 1) / step * step;
+  const uint64_t end = std::min<uint64_t>(range.end, last);
+  if (start > end)
+    return piece;
+  piece.empty = false;
+  piece.start = start;
+  piece.end = start + (end - start) / step * step;
+  piece.step = step;
+  return piece;
+}
+
+uint64_t gcd(uint64_t a, uint64_t b) {
+  while (b) {
+    const uint64_t tmp = a % b;
+    a = b;
+    b = tmp;
+  }
+  return a;
+}
+
+enum Operation { UNITE, INTERSECT, SUBTRACT };
+
+void emit(FrameRanges &output, const Piece &piece) {
+  if (!piece.empty)
+    append(output, piece.start, piece.end, piece.step);
+}
+
+// Combines two pieces of the same segment, frames are only expanded when
+// both pieces are progressions of different steps or phases.
+void combine(Operation operation, const Piece &a, const Piece &b,
+             FrameRanges &output) {
+  // Progressions of the same step either share all their frames or none.
+  const bool sameStep = !a.empty && !b.empty && a.step == b.step;
+  const bool aligned =
+      sameStep &&
+      (std::max(a.start, b.start) - std::min(a.start, b.start)) % a.step == 0;
+  switch (operation) {
+  case UNITE:
+    if (a.empty || (!b.empty && b.step == 1)) {
+      emit(output, b);
+    } else if (b.empty || a.step == 1 || aligned) {
+      emit(output, a);
+    } else {
+      // Merging the frames of both progressions.
+      uint64_t i = a.start, j = b.start;
+      while (i <= a.end || j <= b.end) {
+        const uint64_t frame = j > b.end || (i <= a.end && i <= j) ? i : j;
+        append(output, frame, frame);
+        if (i == frame)
+          i += a.step;
+        if (j == frame)
+          j += b.step;
+      }
+    }
+    break;
+  case INTERSECT:
+    if (a.empty || b.empty)
+      break;
+    if (b.step == 1 || aligned) {
+      emit(output, a);
+    } else if (a.step == 1) {
+      emit(output, b);
+    } else if (!sameStep) {
+      // Common frames form a progression of step lcm(a.step, b.step), its
+      // first frame is within the first b.step frames of a.
+      for (uint64_t frame = a.start; frame <= a.end && frame < a.start +
+                                                               a.step * b.step;
+           frame += a.step) {
+        if (!b.contains(frame))
+          continue;
+        const uint64_t step = a.step / gcd(a.step, b.step) * b.step;
+        const uint64_t last = std::min(a.end, b.end);
+        if (frame <= last)
+          append(output, frame, frame + (last - frame) / step * step, step);
+        break;
+      }
+    }
+    break;
+  case SUBTRACT:
+    if (a.empty)
+      break;
+    if (b.empty || (sameStep && !aligned)) {
+      emit(output, a);
+    } else if (b.step == 1 || aligned) {
+      break;
+    } else if (a.step == 1) {
+      // Gaps between the frames of b, themselves a progression if b.step is
+      // two.
+      if (a.start < b.start)
+        append(output, a.start, b.start - 1);
+      if (b.step == 2 && b.start < b.end)
+        append(output, b.start + 1, b.end - 1, 2);
+      else if (b.step > 2)
+        for (uint64_t frame = b.start; frame < b.end; frame += b.step)
+          append(output, frame + 1, frame + b.step - 1);
+      if (b.end < a.end)
+        append(output, b.end + 1, a.end);
+    } else {
+      for (uint64_t frame = a.start; frame <= a.end; frame += a.step)
+        if (!b.contains(frame))
+          append(output, frame, frame);
+    }
+    break;
+  }
+}
+
+// Splits the frames in segments where each operand is either absent or a
+// single range, and combines them segment by segment.
+FrameRanges apply(Operation operation, const FrameRanges &a,
+                  const FrameRanges &b) {
+  FrameRanges output;
+  const uint64_t none = uint64_t(1) << 33;
+  size_t i = 0, j = 0;
+  uint64_t first = 0;
+  for (;;) {
+    while (i < a.size() && a[i].end < first)
+      ++i;
+    while (j < b.size() && b[j].end < first)
+      ++j;
+    if (i == a.size() && (j == b.size() || operation != UNITE))
+      break;
+    const bool inA = i < a.size() && a[i].start <= first;
+    const bool inB = j < b.size() && b[j].start <= first;
+    const uint64_t cutA =
+        i == a.size() ? none : inA ? uint64_t(a[i].end) + 1 : a[i].start;
+    const uint64_t cutB =
+        j == b.size() ? none : inB ? uint64_t(b[j].end) + 1 : b[j].start;
+    if (!inA && !inB) {
+      first = std::min(cutA, cutB);
+      continue;
+    }
+    const uint64_t last = std::min(cutA, cutB) - 1;
+    const Piece pieceA = inA ? clip(a[i], first, last) : Piece();
+    const Piece pieceB = inB ? clip(b[j], first, last) : Piece();
+    combine(operation, pieceA, pieceB, output);
+    first = last + 1;
+  }
+  return output;
+}
+
+} // namespace
+
+FrameRanges getFrameSet(const Item &item) {
+  FrameRanges output;
+  switch (item.getType()) {
+  case Item::PACKED:
+    if (item.step <= 1)
+      append(output, item.start, item.end);
+    else
+      append(output, item.start,
+             item.start + (item.end - item.start) / item.step * item.step,
+             item.step);
+    break;
+  case Item::INDICED:
+    if (std::is_sorted(item.indices.begin(), item.indices.end())) {
+      appendRuns(output, item.indices);
+    } else {
+      Indices sorted = item.indices;
+      std::sort(sorted.begin(), sorted.end());
+      appendRuns(output, sorted);
+    }
+    break;
+  case Item::GRID:
+    output.emplace_back(item.extents.back().start, item.extents.back().end);
+    break;
+  default:
+    break;
+  }
+  return output;
+}
+
+FrameRanges unite(const FrameRanges &a, const FrameRanges &b) {
+  return apply(UNITE, a, b);
+}
+
+FrameRanges intersect(const FrameRanges &a, const FrameRanges &b) {
+  return apply(INTERSECT, a, b);
+}
+
+FrameRanges subtract(const FrameRanges &a, const FrameRanges &b) {
+  return apply(SUBTRACT, a, b);
+}
+
+FrameRanges getGaps(const FrameRanges &a) {
+  if (a.empty())
+    return FrameRanges();
+  return subtract({FrameRange(a.front().start, a.back().end)}, a);
+}
+
+uint64_t countFrames(const FrameRanges &a) {
+  uint64_t count = 0;
+  for (const FrameRange &range : a) {
+    const uint64_t step = range.step > 1 ? range.step : 1;
+    count += (uint64_t(range.end) - range.start) / step + 1;
+  }
+  return count;
+}
+
+FrameRanges unite(const Item &a, const Item &b) {
+  checkSamePattern(a, b);
+  return unite(getFrameSet(a), getFrameSet(b));
+}
+
+FrameRanges intersect(const Item &a, const Item &b) {
+  checkSamePattern(a, b);
+  return intersect(getFrameSet(a), getFrameSet(b));
+}
+
+FrameRanges subtract(const Item &a, const Item &b) {
+  checkSamePattern(a, b);
+  return subtract(getFrameSet(a), getFrameSet(b));
+}
+
+FrameRanges getGaps(const Item &a) { return getGaps(getFrameSet(a)); }
+
+FrameRanges getFrameSet(const Items &items, CStringView pattern) {
+  FrameRanges output;
+  for (const Item &item : items)
+    if (pattern == CStringView(item.filename))
+      output = unite(output, getFrameSet(item));
+  return output;
+}
+
+Items toItems(CStringView pattern, const FrameRanges &frames) {
+  Items items;
+  items.reserve(frames.size());
+  for (const FrameRange &range : frames) {
+    // Item::step is a char.
+    if (range.step <= Index(std::numeric_limits<char>::max())) {
+      items.push_back(
+          createSequence(pattern, range.start, range.end, range.step));
+    } else {
+      Indices indices;
+      for (uint64_t frame = range.start; frame <= range.end;
+           frame += range.step)
+        indices.push_back(Index(frame));
+      items.push_back(createSequence(pattern, std::move(indices)));
+    }
+  }
+  return items;
+}
+
+} // namespace sequence
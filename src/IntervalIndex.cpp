@@ -0,0 +1,81 @@
+#include "sequence/IntervalIndex.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+#include <sequence/FrameSet.hpp>
+
+namespace sequence {
+
+IntervalIndex::IntervalIndex(const Items &items) {
+  for (size_t i = 0; i < items.size(); ++i) {
+    const Item &item = items[i];
+    switch (item.getType()) {
+    case Item::PACKED:
+      intervals.push_back(
+          {item.start, item.end, Index(item.step > 1 ? item.step : 1), i});
+      break;
+    case Item::INDICED:
+    case Item::GRID:
+      for (const FrameRange &range : getFrameSet(item))
+        intervals.push_back({range.start, range.end, 1, i});
+      break;
+    default:
+      break;
+    }
+  }
+  std::sort(intervals.begin(), intervals.end(),
+            [](const Interval &a, const Interval &b) {
+              return a.start < b.start;
+            });
+  maxEnds.resize(intervals.size());
+  build(0, intervals.size());
+}
+
+// Fills maxEnds for the subtree of intervals[begin, end) and returns its
+// largest end.
+Index IntervalIndex::build(size_t begin, size_t end) {
+  if (begin == end)
+    return 0;
+  const size_t mid = begin + (end - begin) / 2;
+  maxEnds[mid] = std::max({intervals[mid].end, build(begin, mid),
+                           build(mid + 1, end)});
+  return maxEnds[mid];
+}
+
+void IntervalIndex::overlap(size_t begin, size_t end, Index start, Index last,
+                            std::vector<size_t> &found) const {
+  if (begin == end)
+    return;
+  const size_t mid = begin + (end - begin) / 2;
+  if (maxEnds[mid] < start)
+    return;
+  overlap(begin, mid, start, last, found);
+  const Interval &interval = intervals[mid];
+  // The right subtree starts after interval.
+  if (interval.start > last)
+    return;
+  if (interval.end >= start) {
+    // First frame of interval within the query.
+    const Index lowest = std::max(start, interval.start);
+    const uint64_t first =
+        interval.start + (uint64_t(lowest - interval.start) + interval.step -
+                          1) / interval.step * interval.step;
+    if (first <= std::min(last, interval.end))
+      found.push_back(interval.item);
+  }
+  overlap(mid + 1, end, start, last, found);
+}
+
+void IntervalIndex::overlap(Index start, Index end,
+                            std::vector<size_t> &found) const {
+  found.clear();
+  if (start > end)
+    return;
+  overlap(0, intervals.size(), start, end, found);
+  // INDICED Items may have several ranges within the query.
+  std::sort(found.begin(), found.end());
+  found.erase(std::unique(found.begin(), found.end()), found.end());
+}
+
+} // namespace sequence
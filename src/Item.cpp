@@ -10,6 +10,8 @@ Item::Item(CStringView filename, Indices &&indices)
 Item::Type Item::getType() const {
   if (filename.empty())
     return INVALID;
+  if (!extents.empty())
+    return GRID;
   if (!indices.empty())
     return INDICED;
   if (step == -1)
@@ -29,6 +31,8 @@ bool Item::operator<(const Item &o) const {
     case PACKED:
       return std::tie(filename, start, end, padding, step) <
              std::tie(o.filename, o.start, o.end, o.padding, o.step);
+    case GRID:
+      return std::tie(filename, extents) < std::tie(o.filename, o.extents);
     default:
     case INVALID:
       return false;
@@ -48,6 +52,8 @@ bool Item::operator==(const Item &o) const {
     case PACKED:
       return std::tie(filename, start, end, padding, step) ==
              std::tie(o.filename, o.start, o.end, o.padding, o.step);
+    case GRID:
+      return std::tie(filename, extents) == std::tie(o.filename, o.extents);
     default:
     case INVALID:
       return true;
@@ -13,6 +13,8 @@ const char *getTypeString(Item::Type type) {
     return "indiced";
   case Item::PACKED:
     return "packed";
+  case Item::GRID:
+    return "grid";
   }
   assert(false);
   return "error";
@@ -41,6 +43,12 @@ std::ostream &operator<<(std::ostream &stream, const sequence::Item &item) {
              << (int)item.step << " #" << (int)item.padding;
     }
     break;
+  case sequence::Item::GRID:
+    stream << item.filename << " ";
+    for (size_t i = 0; i < item.extents.size(); ++i)
+      stream << (i ? "x[" : "[") << item.extents[i].start << ":"
+             << item.extents[i].end << "]";
+    break;
   }
   return stream;
 }
@@ -0,0 +1,168 @@
+#include "sequence/ItemLookup.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+#include <sequence/Tools.hpp>
+#include <sequence/details/StringUtils.hpp>
+
+namespace sequence {
+
+namespace {
+
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+} // namespace
+
+ItemLookup::ItemLookup(const Items &items) {
+  for (const Item &item : items) {
+    Index start, end;
+    switch (item.getType()) {
+    case Item::SINGLE:
+      singles.emplace(item.filename, &item);
+      continue;
+    case Item::INDICED:
+      if (std::adjacent_find(item.indices.begin(), item.indices.end(),
+                             std::greater_equal<Index>()) !=
+          item.indices.end())
+        throw std::invalid_argument("Item indices must be sorted");
+      start = item.indices.front();
+      end = item.indices.back();
+      break;
+    case Item::PACKED:
+      start = item.start;
+      end = item.end;
+      break;
+    default:
+      continue;
+    }
+    const auto pair = getPrefixAndSuffix(item.filename);
+    const CStringView prefix = pair.first, suffix = pair.second;
+    const unsigned char padding =
+        item.filename.size() - prefix.size() - suffix.size();
+    auto &keyed = groups[concat(prefix, "#", suffix)];
+    auto group = std::find_if(
+        keyed.begin(), keyed.end(),
+        [padding](const Group &group) { return group.padding == padding; });
+    if (group == keyed.end())
+      group = keyed.insert(keyed.end(), Group{prefix.size(), suffix.size(),
+                                              padding, {}});
+    group->sequences.push_back({&item, start, end, end});
+  }
+  for (auto &pair : groups) {
+    for (Group &group : pair.second) {
+      auto &sequences = group.sequences;
+      std::stable_sort(sequences.begin(), sequences.end(),
+                       [](const Sequence &a, const Sequence &b) {
+                         return a.start < b.start;
+                       });
+      for (size_t i = 1; i < sequences.size(); ++i)
+        sequences[i].maxEnd =
+            std::max(sequences[i].end, sequences[i - 1].maxEnd);
+    }
+  }
+}
+
+const Item *ItemLookup::Group::find(Index frame, const Item **closest) const {
+  auto itr = std::upper_bound(
+      sequences.begin(), sequences.end(), frame,
+      [](Index frame, const Sequence &sequence) {
+        return frame < sequence.start;
+      });
+  if (closest)
+    *closest = itr == sequences.begin() ? nullptr : (itr - 1)->item;
+  // Walking back while a previous sequence may still hold frame.
+  for (; itr != sequences.begin() && (itr - 1)->maxEnd >= frame; --itr)
+    if ((itr - 1)->end >= frame && contains(*(itr - 1)->item, frame))
+      return (itr - 1)->item;
+  return nullptr;
+}
+
+// Calls callback(group, frame) for each group of sequences filename may
+// belong to until it returns true.
+template <typename Callback>
+void ItemLookup::forEachGroup(CStringView filename, Callback callback) const {
+  std::string key;
+  const size_t size = filename.size();
+  for (size_t begin = 0; begin < size;) {
+    if (!isDigit(filename[begin])) {
+      ++begin;
+      continue;
+    }
+    size_t end = begin;
+    uint64_t value = 0;
+    for (; end < size && isDigit(filename[end]); ++end)
+      value = std::min<uint64_t>(value * 10 + (filename[end] - '0'),
+                                 uint64_t(std::numeric_limits<Index>::max()) +
+                                     1);
+    const size_t digits = end - begin;
+    if (value <= std::numeric_limits<Index>::max()) {
+      key.assign(filename.begin(), begin);
+      key += PADDING_CHAR;
+      key.append(filename.begin() + end, size - end);
+      const auto itr = groups.find(key);
+      if (itr != groups.end()) {
+        for (const Group &group : itr->second) {
+          // Frames are padded with zeros up to the sequence padding.
+          if (group.prefix != begin || group.suffix != size - end ||
+              digits < group.padding ||
+              (digits > group.padding && filename[begin] == '0'))
+            continue;
+          if (callback(group, Index(value)))
+            return;
+        }
+      }
+    }
+    begin = end;
+  }
+}
+
+const Item *ItemLookup::find(CStringView filename) const {
+  const auto itr = singles.find(filename.toString());
+  if (itr != singles.end())
+    return itr->second;
+  const Item *found = nullptr;
+  forEachGroup(filename, [&found](const Group &group, Index frame) {
+    found = group.find(frame, nullptr);
+    return found != nullptr;
+  });
+  return found;
+}
+
+const Item *ItemLookup::findSequence(CStringView filename,
+                                     Index &frame) const {
+  const Item *found = nullptr;
+  forEachGroup(filename, [&](const Group &group, Index current) {
+    const Item *closest;
+    const Item *const holding = group.find(current, &closest);
+    if (holding || !found) {
+      found = holding;
+      if (!found)
+        found = closest ? closest : group.sequences.front().item;
+      frame = current;
+    }
+    return holding != nullptr;
+  });
+  return found;
+}
+
+bool contains(const Item &item, Index frame) {
+  switch (item.getType()) {
+  case Item::PACKED:
+    return frame >= item.start && frame <= item.end &&
+           (frame - item.start) % Index(item.step > 0 ? item.step : 1) == 0;
+  case Item::INDICED:
+    return std::binary_search(item.indices.begin(), item.indices.end(),
+                              frame);
+  case Item::GRID:
+    return frame >= item.extents.back().start &&
+           frame <= item.extents.back().end;
+  default:
+    return false;
+  }
+}
+
+} // namespace sequence
@@ -0,0 +1,30 @@
+#include "sequence/Matcher.hpp"
+
+#include <algorithm>
+
+#include "sequence/Common.hpp"
+
+namespace sequence {
+
+Matcher::Matcher(CStringView pattern, bool ignoreCase)
+    : pattern_(pattern.toString()), ignoreCase_(ignoreCase) {
+  if (pattern_.empty())
+    throw std::invalid_argument("empty pattern");
+  std::replace(pattern_.begin(), pattern_.end(), '@', char(PADDING_CHAR));
+  const auto padding =
+      std::count(pattern_.begin(), pattern_.end(), char(PADDING_CHAR));
+  if (padding == 0)
+    throw std::invalid_argument(
+        "pattern should contain a padding character '#' or '@'");
+  anyPadding_ = padding == 1;
+  if (ignoreCase_)
+    std::transform(pattern_.begin(), pattern_.end(), pattern_.begin(),
+                   details::toLower);
+  const size_t firstStar = pattern_.find('*');
+  if (firstStar != std::string::npos) {
+    firstStar_ = firstStar;
+    lastStar_ = pattern_.rfind('*');
+  }
+}
+
+} // namespace sequence
@@ -1,5 +1,8 @@
 #include "sequence/Parser.hpp"
 
+#include <cstring>
+#include <future>
+#include <memory>
 #include <string>
 
 #if defined(_WIN64) || defined(_WIN32)
@@ -9,6 +12,7 @@
 #include <sys/stat.h>
 #endif
 
+#include "sequence/ParserStrategies.hpp"
 #include "sequence/details/Utils.hpp"
 #include "sequence/details/ParserUtils.hpp"
 
@@ -16,15 +20,42 @@ using namespace sequence::details;
 
 namespace sequence {
 
-FolderContent parse(const Configuration &config,
-                    GetNextEntryFunction getNextEntry) {
-  FolderContent result;
-  Items &directories = result.directories;
-  Items &files = result.files;
+namespace {
+
+bool startsWith(CStringView name, const std::string &prefix) {
+  return name.size() >= prefix.size() &&
+         memcmp(name.begin(), prefix.data(), prefix.size()) == 0;
+}
+
+bool endsWith(CStringView name, const std::string &suffix) {
+  return name.size() >= suffix.size() &&
+         memcmp(name.end() - suffix.size(), suffix.data(), suffix.size()) == 0;
+}
+
+bool anyOf(const std::vector<std::string> &strings, CStringView name,
+           bool (*predicate)(CStringView, const std::string &)) {
+  for (const auto &string : strings)
+    if (predicate(name, string))
+      return true;
+  return false;
+}
+
+// Scans entries and buckets files, splitting recursively to retain a single
+// location.
+// Ranges gathered during ingestion are kept only if keepRanges is set,
+// otherwise all indices are available in sortedIndices.
+SplitBuckets scan(const Configuration &config,
+                  GetNextEntryFunction getNextEntry, Items &directories,
+                  bool keepRanges, const SplitFunction &split) {
   // Scanning and bucketing files.
   FileBucketizer bucketizer;
   FilesystemEntry entry;
+  const bool filtered = !config.includeSuffixes.empty() ||
+                        !config.excludePrefixes.empty() ||
+                        !config.excludeSuffixes.empty();
   while (getNextEntry(entry)) {
+    if (filtered && !acceptEntry(config, entry))
+      continue;
     if (entry.isDirectory) {
       directories.emplace_back(entry.filename);
     } else {
@@ -32,7 +63,48 @@ FolderContent parse(const Configuration &config,
     }
   }
   // Splitting recursively to retain a single location.
-  auto buckets = splitAllAndSort(config.getPivotIndex, bucketizer.transfer());
+  auto buckets = split(bucketizer.transfer());
+  if (!keepRanges || config.mergePadding) {
+    for (auto &bucket : buckets) {
+      bucket.unpack();
+    }
+  }
+  return buckets;
+}
+
+// Splits with the predefined strategy of config, selected once per directory.
+SplitFunction getDefaultSplitFunction(const Configuration &config,
+                                      bool detectGrids) {
+  return [&config, detectGrids](Buckets buckets) {
+    return splitAllAndSort(config.getPivotIndex, std::move(buckets),
+                           detectGrids);
+  };
+}
+
+} // namespace
+
+bool acceptEntry(const Configuration &config, const FilesystemEntry &entry) {
+  const CStringView name = entry.filename;
+  if (!entry.isDirectory && !config.includeSuffixes.empty() &&
+      !anyOf(config.includeSuffixes, name, endsWith))
+    return false;
+  return !anyOf(config.excludePrefixes, name, startsWith) &&
+         !anyOf(config.excludeSuffixes, name, endsWith);
+}
+
+FolderContent parse(const Configuration &config,
+                    GetNextEntryFunction getNextEntry) {
+  return details::parse(config, std::move(getNextEntry),
+                        getDefaultSplitFunction(config, config.detectGrids));
+}
+
+FolderContent details::parse(const Configuration &config,
+                             GetNextEntryFunction getNextEntry,
+                             const SplitFunction &split) {
+  FolderContent result;
+  Items &directories = result.directories;
+  Items &files = result.files;
+  auto buckets = scan(config, getNextEntry, directories, config.pack, split);
   // Merging padding if necessary.
   if (config.mergePadding && buckets.size() >= 2) {
     mergeCompatiblePadding(buckets);
@@ -56,6 +128,71 @@ FolderContent parse(const Configuration &config,
   return result;
 }
 
+MergedFolderContent parse(const Configuration &config,
+                          std::vector<GetNextEntryFunction> getNextEntries) {
+  return details::parse(config, std::move(getNextEntries),
+                        getDefaultSplitFunction(config, false));
+}
+
+MergedFolderContent
+details::parse(const Configuration &config,
+               std::vector<GetNextEntryFunction> getNextEntries,
+               const SplitFunction &split) {
+  MergedFolderContent result;
+  Items &directories = result.directories;
+  Items &files = result.files;
+  // Scanning roots concurrently.
+  std::vector<std::future<SplitBuckets>> futures;
+  std::vector<Items> rootDirectories(getNextEntries.size());
+  for (size_t root = 0; root < getNextEntries.size(); ++root) {
+    futures.push_back(std::async(std::launch::async, scan, std::cref(config),
+                                 std::move(getNextEntries[root]),
+                                 std::ref(rootDirectories[root]), false,
+                                 std::cref(split)));
+  }
+  std::vector<SplitBuckets> perRoot;
+  for (auto &future : futures) {
+    perRoot.push_back(future.get());
+  }
+  // Directories are reported once.
+  for (auto &items : rootDirectories) {
+    std::move(std::begin(items), std::end(items),
+              std::back_inserter(directories));
+  }
+  std::sort(std::begin(directories), std::end(directories));
+  directories.erase(std::unique(std::begin(directories), std::end(directories)),
+                    std::end(directories));
+  // Union of buckets sharing the same pattern, single files split apart from
+  // their sequence in their root included, then merging padding across roots
+  // if necessary.
+  rekeySingleFiles(perRoot);
+  auto rootedBuckets = unionSplitBuckets(std::move(perRoot));
+  if (config.mergePadding && rootedBuckets.size() >= 2) {
+    mergeCompatiblePadding(rootedBuckets);
+  }
+  for (auto &rooted : rootedBuckets) {
+    SplitBucket &bucket = rooted.bucket;
+    const Origins origins = getOrigins(rooted);
+    // Packing indices if needed.
+    if (config.pack) {
+      bucket.pack();
+    }
+    // Output items, each packed range having its own origins.
+    size_t range = 0;
+    bucket.output(config.bakeSingleton, [&](Item item) {
+      files.push_back(std::move(item));
+      if (bucket.ranges.empty()) {
+        result.origins.push_back(origins);
+      } else {
+        const Range &current = bucket.ranges[range++];
+        result.origins.push_back(
+            clipOrigins(origins, current.start, current.end));
+      }
+    });
+  }
+  return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 #if defined(_WIN64) || defined(_WIN32)
 struct Lister {
@@ -85,6 +222,8 @@ public:
     };
   }
 
+  bool opened() const { return hFind != INVALID_HANDLE_VALUE; }
+
   ~Lister() {
     if (hFind != INVALID_HANDLE_VALUE)
       FindClose(hFind);
@@ -145,6 +284,8 @@ public:
     };
   }
 
+  bool opened() const { return pDir != nullptr; }
+
   ~Lister() {
     if (pDir)
       closedir(pDir);
@@ -157,9 +298,53 @@ public:
 
 FolderContent parseDir(const Configuration &configuration,
                        CStringView foldername) {
+  return details::parseDir(
+      configuration, foldername,
+      getDefaultSplitFunction(configuration, configuration.detectGrids));
+}
+
+FolderContent details::parseDir(const Configuration &configuration,
+                                CStringView foldername,
+                                const SplitFunction &split) {
   Lister lister(foldername.ptr());
-  auto content = parse(configuration, lister.getNextEntryFunction());
+  auto content = parse(configuration, lister.getNextEntryFunction(), split);
   content.name = foldername.toString();
+  if (configuration.gatherStats)
+    content.stats = getItemsStats(foldername, content.files);
+  return content;
+}
+
+bool listDir(CStringView foldername,
+             std::function<void(const FilesystemEntry &)> onEntry) {
+  Lister lister(foldername.ptr());
+  if (!lister.opened())
+    return false;
+  auto getNextEntry = lister.getNextEntryFunction();
+  FilesystemEntry entry;
+  while (getNextEntry(entry)) {
+    onEntry(entry);
+  }
+  return true;
+}
+
+MergedFolderContent parseDirs(const Configuration &configuration,
+                              const std::vector<std::string> &foldernames) {
+  return details::parseDirs(configuration, foldernames,
+                            getDefaultSplitFunction(configuration, false));
+}
+
+MergedFolderContent
+details::parseDirs(const Configuration &configuration,
+                   const std::vector<std::string> &foldernames,
+                   const SplitFunction &split) {
+  std::vector<std::unique_ptr<Lister>> listers;
+  std::vector<GetNextEntryFunction> getNextEntries;
+  for (const auto &foldername : foldernames) {
+    listers.emplace_back(new Lister(foldername.c_str()));
+    getNextEntries.push_back(listers.back()->getNextEntryFunction());
+  }
+  auto content = parse(configuration, std::move(getNextEntries), split);
+  content.roots = foldernames;
   return content;
 }
 
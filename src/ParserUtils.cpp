@@ -1,5 +1,13 @@
 #include "sequence/details/ParserUtils.hpp"
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+
+#include "sequence/ParserStrategies.hpp"
+
 namespace sequence {
 namespace details {
 
@@ -32,60 +40,120 @@ size_t retainHighestVariance(const Bucket &bucket) {
   return lowestVarianceIndex;
 }
 
-size_t getPivotIndex(const SplitIndexStrategy strategy, const Bucket &bucket) {
-  switch (strategy) {
-  case RETAIN_NONE:
-    return retainNone(bucket);
-  case RETAIN_LAST_LOCATION:
-    return retainLast(bucket);
-  case RETAIN_FIRST_LOCATION:
-    return retainFirst(bucket);
-  case RETAIN_HIGHEST_VARIANCE:
-    return retainHighestVariance(bucket);
-  default:
-    assert(0);
+namespace {
+
+// Predicted outcome of retaining a column : the other columns are split,
+// giving one Item per distinct tuple of their values, each Item holding the
+// runs of consecutive values of the retained column.
+struct RetainCost {
+  size_t items = 0, ranges = 0;
+
+  size_t total() const { return items + ranges; }
+};
+
+RetainCost getRetainCost(const Bucket &bucket, size_t retained) {
+  const Indices &values = bucket.columns[retained];
+  // Rows sorted by the values of the other columns, then the retained one.
+  // Comparing actual values, rows of distinct tuples are never grouped.
+  std::vector<size_t> rows(values.size());
+  for (size_t row = 0; row < rows.size(); ++row)
+    rows[row] = row;
+  const auto compareGroups = [&](size_t a, size_t b) {
+    for (size_t column = 0; column < bucket.columns.size(); ++column) {
+      if (column == retained)
+        continue;
+      const Indices &other = bucket.columns[column];
+      if (other[a] != other[b])
+        return other[a] < other[b] ? -1 : 1;
+    }
+    return 0;
+  };
+  std::sort(std::begin(rows), std::end(rows), [&](size_t a, size_t b) {
+    const int group = compareGroups(a, b);
+    return group ? group < 0 : values[a] < values[b];
+  });
+  RetainCost cost;
+  for (size_t i = 0; i < rows.size(); ++i) {
+    const bool sameGroup = i > 0 && compareGroups(rows[i - 1], rows[i]) == 0;
+    if (!sameGroup)
+      ++cost.items;
+    if (!sameGroup || values[rows[i]] > values[rows[i - 1]] + 1)
+      ++cost.ranges;
   }
+  return cost;
 }
 
-SplitBuckets splitAllAndSort(const SplitIndexStrategy strategy,
-                             Buckets splittable_buckets) {
-  SplitBuckets buckets;
-  const auto pusher = [&splittable_buckets](Bucket b) {
-    splittable_buckets.push_back(std::move(b));
-  };
-  // Recursively splitting buckets.
-  while (!splittable_buckets.empty()) {
-    Bucket bucket = std::move(splittable_buckets.back());
-    splittable_buckets.pop_back();
-    if (bucket.splittable()) {
-      const size_t index = getPivotIndex(strategy, bucket);
-      if (index == LOCATION_NONE) {
-        bucket.flatten(pusher);
-      } else {
-        bucket.split(index, pusher);
-      }
-    } else {
-      if (bucket.single()) {
-        bucket.flatten(pusher);
-      } else {
-        buckets.emplace_back(std::move(bucket));
-      }
+} // namespace
+
+size_t retainFewestItems(const Bucket &bucket) {
+  assert(!bucket.columns.empty());
+  const size_t columns = bucket.columns.size();
+  std::vector<size_t> distinct(columns);
+  for (size_t i = 0; i < columns; ++i)
+    distinct[i] = estimateDistinctIndices(bucket.columns[i]);
+  // A constant column splits into a single sub bucket and is never worth
+  // retaining : splitting it first gives the same outcome without sorting.
+  // Sub buckets left with one varying column are settled here.
+  for (size_t i = 0; i < columns; ++i) {
+    const Indices &column = bucket.columns[i];
+    if (distinct[i] == 1 &&
+        std::adjacent_find(std::begin(column), std::end(column),
+                           std::not_equal_to<Index>()) == std::end(column))
+      return i;
+  }
+  // Retaining the cheapest column, the one with the most distinct values on
+  // ties like retainHighestVariance.
+  size_t retained = 0;
+  size_t lowestCost = std::numeric_limits<size_t>::max();
+  for (size_t i = 0; i < columns; ++i) {
+    const size_t cost = getRetainCost(bucket, i).total();
+    if (cost < lowestCost ||
+        (cost == lowestCost && distinct[i] > distinct[retained])) {
+      lowestCost = cost;
+      retained = i;
     }
   }
-  std::sort(std::begin(buckets), std::end(buckets));
-  return buckets;
+  // Splitting the other column with the fewest distinct values first, sub
+  // buckets with more than one varying column are evaluated again.
+  size_t pivot = LOCATION_NONE;
+  for (size_t i = 0; i < columns; ++i)
+    if (i != retained &&
+        (pivot == LOCATION_NONE || distinct[i] < distinct[pivot]))
+      pivot = i;
+  return pivot;
+}
+
+namespace {
+
+struct SplitAllAndSort {
+  Buckets &buckets;
+  bool detectGrids;
+
+  template <typename Strategy> SplitBuckets operator()(Strategy strategy) {
+    return splitAllAndSort(strategy, std::move(buckets), detectGrids);
+  }
+};
+
+} // namespace
+
+SplitBuckets splitAllAndSort(const SplitIndexStrategy strategy,
+                             Buckets splittable_buckets, bool detectGrids) {
+  return withStrategy(strategy,
+                      SplitAllAndSort{splittable_buckets, detectGrids});
 }
 
 // Adapted from std::unique.
 // http://en.cppreference.com/w/cpp/algorithm/unique
-template <class ForwardIt> ForwardIt merge(ForwardIt first, ForwardIt last) {
+template <class ForwardIt, class CanMerge, class Merge>
+ForwardIt merge(ForwardIt first, ForwardIt last, CanMerge canMerge,
+                Merge mergeInto) {
   if (first == last)
     return last;
 
   ForwardIt result = first;
   while (++first != last) {
-    if (result->canMerge(*first)) {
-      *result = SplitBucket(*result, *first);
+    if (canMerge(*result, *first)) {
+      mergeInto(*result, *first);
     } else if (++result != first) {
       *result = std::move(*first);
     }
@@ -96,11 +164,257 @@ template <class ForwardIt> ForwardIt merge(ForwardIt first, ForwardIt last) {
 // This is implemented as a sort + unique algorithm with predicate comparing
 // patterns without taking padding into account.
 // When two buckets compares equals (i.e. to be merged) and the indices are
-// compatible buckets are merged.
+// compatible buckets are merged. Buckets are sorted by pattern afterwards.
 void mergeCompatiblePadding(SplitBuckets &buckets) {
-  assert(std::is_sorted(std::begin(buckets), std::end(buckets)));
-  buckets.erase(merge(std::begin(buckets), std::end(buckets)),
-                std::end(buckets));
+  const auto less = [](const SplitBucket &a, const SplitBucket &b) {
+    return noPaddingLess(a, b);
+  };
+  std::stable_sort(std::begin(buckets), std::end(buckets), less);
+  const auto canMerge = [](const SplitBucket &a, const SplitBucket &b) {
+    return a.canMerge(b);
+  };
+  const auto mergeInto = [](SplitBucket &a, SplitBucket &b) {
+    a = SplitBucket(a, b);
+  };
+  buckets.erase(
+      merge(std::begin(buckets), std::end(buckets), canMerge, mergeInto),
+      std::end(buckets));
+  std::sort(std::begin(buckets), std::end(buckets));
+}
+
+namespace {
+
+typedef std::pair<Index, size_t> RootedIndex;
+
+bool indexLess(const RootedIndex &a, const RootedIndex &b) {
+  return a.first < b.first;
+}
+
+bool indexEqual(const RootedIndex &a, const RootedIndex &b) {
+  return a.first == b.first;
+}
+
+// Unions buckets sharing the same pattern, first root winning on duplicates.
+RootedSplitBucket
+unionGroup(std::vector<std::pair<SplitBucket *, size_t>> group) {
+  RootedSplitBucket output;
+  SplitBucket &first = *group.front().first;
+  const size_t firstRoot = group.front().second;
+  if (first.sortedIndices.empty()) {
+    for (const auto &pair : group)
+      output.roots.push_back(pair.second);
+  } else if (group.size() == 1) {
+    output.roots.assign(first.sortedIndices.size(), firstRoot);
+  } else {
+    std::vector<RootedIndex> merged, tmp, current;
+    for (const auto &pair : group) {
+      current.clear();
+      for (const Index index : pair.first->sortedIndices)
+        current.emplace_back(index, pair.second);
+      tmp.clear();
+      std::merge(std::begin(merged), std::end(merged), std::begin(current),
+                 std::end(current), std::back_inserter(tmp), indexLess);
+      merged.swap(tmp);
+    }
+    merged.erase(std::unique(std::begin(merged), std::end(merged), indexEqual),
+                 std::end(merged));
+    first.sortedIndices.clear();
+    for (const auto &rooted : merged) {
+      first.sortedIndices.push_back(rooted.first);
+      output.roots.push_back(rooted.second);
+    }
+  }
+  output.bucket = std::move(first);
+  return output;
+}
+
+} // namespace
+
+namespace {
+
+// A single file seen as one frame of a sequence.
+struct Candidate {
+  std::string pattern;
+  Index value;
+};
+
+// Returns the patterns filename could belong to, one per location holding
+// an index, the last location first.
+std::vector<Candidate> getCandidates(const std::string &filename) {
+  std::vector<Candidate> candidates;
+  if (CStringView(filename).contains(PADDING_CHAR))
+    return candidates;
+  std::string normalized = filename;
+  Indices indices;
+  extractFileIndicesAndNormalize(
+      StringView(&normalized[0], normalized.size()), indices);
+  const auto placeholders =
+      getPlaceholders(StringView(&normalized[0], normalized.size()));
+  assert(placeholders.size() == indices.size());
+  for (size_t i = placeholders.size(); i-- > 0;) {
+    std::string pattern = filename;
+    pattern.replace(placeholders[i].begin() - normalized.data(),
+                    placeholders[i].size(), placeholders[i].size(),
+                    PADDING_CHAR);
+    candidates.push_back({std::move(pattern), indices[i]});
+  }
+  return candidates;
+}
+
+bool isSingleFile(const SplitBucket &bucket) {
+  return bucket.sortedIndices.empty() && bucket.ranges.empty() &&
+         bucket.extents.empty();
+}
+
+} // namespace
+
+void rekeySingleFiles(std::vector<SplitBuckets> &perRoot) {
+  if (perRoot.size() < 2)
+    return;
+  // Roots holding each sequence pattern, single files holding each candidate.
+  std::unordered_map<std::string, std::vector<size_t>> sequences;
+  std::unordered_map<std::string, std::vector<std::pair<size_t, Index>>>
+      singles;
+  for (size_t root = 0; root < perRoot.size(); ++root) {
+    for (const SplitBucket &bucket : perRoot[root]) {
+      if (!bucket.sortedIndices.empty()) {
+        sequences[bucket.pattern].push_back(root);
+      } else if (isSingleFile(bucket)) {
+        for (const Candidate &candidate : getCandidates(bucket.pattern))
+          singles[candidate.pattern].emplace_back(root, candidate.value);
+      }
+    }
+  }
+  // A single file joins a sequence of another root, or other single files of
+  // other roots with other values.
+  const auto joins = [&](size_t root, const Candidate &candidate) {
+    const auto sequence = sequences.find(candidate.pattern);
+    if (sequence != sequences.end())
+      for (const size_t other : sequence->second)
+        if (other != root)
+          return true;
+    for (const auto &other : singles[candidate.pattern])
+      if (other.first != root && other.second != candidate.value)
+        return true;
+    return false;
+  };
+  for (size_t root = 0; root < perRoot.size(); ++root) {
+    bool rekeyed = false;
+    for (SplitBucket &bucket : perRoot[root]) {
+      if (!isSingleFile(bucket))
+        continue;
+      for (Candidate &candidate : getCandidates(bucket.pattern)) {
+        if (joins(root, candidate)) {
+          bucket.pattern = std::move(candidate.pattern);
+          bucket.sortedIndices.push_back(candidate.value);
+          rekeyed = true;
+          break;
+        }
+      }
+    }
+    if (rekeyed)
+      std::sort(std::begin(perRoot[root]), std::end(perRoot[root]));
+  }
+}
+
+RootedSplitBuckets unionSplitBuckets(std::vector<SplitBuckets> perRoot) {
+  RootedSplitBuckets output;
+  std::vector<size_t> cursors(perRoot.size(), 0);
+  std::vector<std::pair<SplitBucket *, size_t>> group;
+  for (;;) {
+    // Finding the smallest pattern among the heads of all roots.
+    const std::string *smallest = nullptr;
+    for (size_t root = 0; root < perRoot.size(); ++root) {
+      if (cursors[root] < perRoot[root].size()) {
+        const std::string &pattern = perRoot[root][cursors[root]].pattern;
+        if (!smallest || pattern < *smallest)
+          smallest = &pattern;
+      }
+    }
+    if (!smallest)
+      break;
+    // Gathering all the buckets with this pattern.
+    group.clear();
+    for (size_t root = 0; root < perRoot.size(); ++root) {
+      auto &buckets = perRoot[root];
+      auto &cursor = cursors[root];
+      while (cursor < buckets.size() && buckets[cursor].pattern == *smallest) {
+        group.emplace_back(&buckets[cursor], root);
+        ++cursor;
+      }
+    }
+    output.push_back(unionGroup(group));
+  }
+  return output;
+}
+
+void mergeCompatiblePadding(RootedSplitBuckets &buckets) {
+  const auto less = [](const RootedSplitBucket &a, const RootedSplitBucket &b) {
+    return noPaddingLess(a.bucket, b.bucket);
+  };
+  std::stable_sort(std::begin(buckets), std::end(buckets), less);
+  const auto canMerge = [](const RootedSplitBucket &a,
+                           const RootedSplitBucket &b) {
+    return a.bucket.canMerge(b.bucket);
+  };
+  // Indices are disjoint, roots follow their indices in the merged order.
+  const auto mergeInto = [](RootedSplitBucket &a, RootedSplitBucket &b) {
+    std::vector<RootedIndex> merged;
+    const Indices &first = a.bucket.sortedIndices;
+    const Indices &second = b.bucket.sortedIndices;
+    size_t i = 0, j = 0;
+    while (i < first.size() || j < second.size()) {
+      if (j == second.size() || (i < first.size() && first[i] < second[j])) {
+        merged.emplace_back(first[i], a.roots[i]);
+        ++i;
+      } else {
+        merged.emplace_back(second[j], b.roots[j]);
+        ++j;
+      }
+    }
+    a.bucket = SplitBucket(a.bucket, b.bucket);
+    a.roots.clear();
+    for (const auto &rooted : merged)
+      a.roots.push_back(rooted.second);
+  };
+  buckets.erase(
+      merge(std::begin(buckets), std::end(buckets), canMerge, mergeInto),
+      std::end(buckets));
+  std::sort(std::begin(buckets), std::end(buckets),
+            [](const RootedSplitBucket &a, const RootedSplitBucket &b) {
+              return a.bucket < b.bucket;
+            });
+}
+
+Origins getOrigins(const RootedSplitBucket &rooted) {
+  Origins origins;
+  const Indices &indices = rooted.bucket.sortedIndices;
+  const auto &roots = rooted.roots;
+  if (indices.empty()) {
+    for (const size_t root : roots)
+      origins.push_back(Origin{root, Index(-1), Index(-1)});
+    return origins;
+  }
+  assert(indices.size() == roots.size());
+  for (size_t i = 0; i < indices.size(); ++i) {
+    if (origins.empty() || origins.back().root != roots[i]) {
+      origins.push_back(Origin{roots[i], indices[i], indices[i]});
+    } else {
+      origins.back().end = indices[i];
+    }
+  }
+  return origins;
+}
+
+Origins clipOrigins(const Origins &origins, Index start, Index end) {
+  Origins clipped;
+  for (const Origin &origin : origins) {
+    if (origin.end < start || origin.start > end)
+      continue;
+    clipped.push_back(Origin{origin.root, std::max(origin.start, start),
+                             std::min(origin.end, end)});
+  }
+  return clipped;
 }
 
 bool noPaddingLess(const Bucket &a, const Bucket &b) {
@@ -108,5 +422,17 @@ bool noPaddingLess(const Bucket &a, const Bucket &b) {
          getInternalPrefixAndSuffix(b.pattern);
 }
 
+bool noPaddingLess(const SplitBucket &a, const SplitBucket &b) {
+  // Buckets without padding come after the ones they share text with.
+  const bool aPadded = a.containsPadding(), bPadded = b.containsPadding();
+  const auto aKey = aPadded ? getInternalPrefixAndSuffix(a.pattern)
+                            : std::make_pair(CStringView(a.pattern),
+                                             CStringView());
+  const auto bKey = bPadded ? getInternalPrefixAndSuffix(b.pattern)
+                            : std::make_pair(CStringView(b.pattern),
+                                             CStringView());
+  return std::tie(aKey, bPadded) < std::tie(bKey, aPadded);
+}
+
 } // namespace details
 } // namespace sequence
@@ -0,0 +1,147 @@
+#include "sequence/PatternSet.hpp"
+
+#include <algorithm>
+#include <queue>
+
+namespace sequence {
+
+namespace {
+
+// Returns the longest run of characters without '#', '@' or '*'.
+std::string getLongestLiteral(const std::string &pattern, bool ignoreCase) {
+  CStringView longest;
+  size_t begin = 0;
+  for (size_t i = 0; i <= pattern.size(); ++i) {
+    if (i < pattern.size() && pattern[i] != '#' && pattern[i] != '@' &&
+        pattern[i] != '*')
+      continue;
+    if (i - begin > longest.size())
+      longest = CStringView(pattern.data() + begin, i - begin);
+    begin = i + 1;
+  }
+  std::string literal = longest.toString();
+  if (ignoreCase)
+    std::transform(literal.begin(), literal.end(), literal.begin(),
+                   details::toLower);
+  return literal;
+}
+
+} // namespace
+
+PatternSet::PatternSet(const std::vector<std::string> &patterns,
+                       bool ignoreCase)
+    : ignoreCase_(ignoreCase) {
+  std::vector<std::string> literals;
+  for (const auto &pattern : patterns) {
+    matchers_.emplace_back(pattern, ignoreCase);
+    literals.push_back(getLongestLiteral(pattern, ignoreCase));
+    for (const char c : literals.back()) {
+      uint8_t &klass = classes_[uint8_t(c)];
+      if (klass == 0)
+        klass = classCount_++;
+    }
+  }
+  nodes_.emplace_back(); // root
+  transitions_.resize(classCount_, 0);
+  for (size_t i = 0; i < literals.size(); ++i) {
+    if (literals[i].empty())
+      unindexed_.push_back(i);
+    else
+      addLiteral(literals[i], i);
+  }
+  build();
+}
+
+// Inserts literal in the trie, 0 denoting a missing child.
+void PatternSet::addLiteral(const std::string &literal, size_t pattern) {
+  uint32_t node = 0;
+  for (const char c : literal) {
+    const size_t transition = node * classCount_ + classes_[uint8_t(c)];
+    if (transitions_[transition] == 0) {
+      transitions_[transition] = nodes_.size();
+      nodes_.emplace_back();
+      transitions_.resize(transitions_.size() + classCount_, 0);
+    }
+    node = transitions_[transition];
+  }
+  nodes_[node].outputs.push_back(pattern);
+}
+
+// Computes failure links breadth first and turns the trie into a complete
+// automaton : missing transitions follow the failure link.
+void PatternSet::build() {
+  std::queue<uint32_t> queue;
+  for (size_t klass = 0; klass < classCount_; ++klass)
+    if (const uint32_t child = transitions_[klass])
+      queue.push(child); // fail is root
+  while (!queue.empty()) {
+    const uint32_t node = queue.front();
+    queue.pop();
+    const uint32_t fail = nodes_[node].fail;
+    for (size_t klass = 0; klass < classCount_; ++klass) {
+      uint32_t &transition = transitions_[node * classCount_ + klass];
+      const uint32_t fallback = transitions_[fail * classCount_ + klass];
+      if (transition == 0) {
+        transition = fallback;
+        continue;
+      }
+      Node &child = nodes_[transition];
+      child.fail = fallback;
+      const auto &inherited = nodes_[fallback].outputs;
+      child.outputs.insert(child.outputs.end(), inherited.begin(),
+                           inherited.end());
+      queue.push(transition);
+    }
+  }
+}
+
+template <typename Callback>
+bool PatternSet::forEachCandidate(CStringView candidate,
+                                  Callback callback) const {
+  uint32_t node = 0;
+  for (char c : candidate) {
+    if (ignoreCase_)
+      c = details::toLower(c);
+    node = transitions_[node * classCount_ + classes_[uint8_t(c)]];
+    for (const uint32_t pattern : nodes_[node].outputs)
+      if (callback(pattern))
+        return true;
+  }
+  for (const size_t pattern : unindexed_)
+    if (callback(pattern))
+      return true;
+  return false;
+}
+
+void PatternSet::match(CStringView candidate,
+                       std::vector<size_t> &matched) const {
+  matched.clear();
+  if (nodes_.empty())
+    return;
+  forEachCandidate(candidate, [&matched](size_t pattern) {
+    matched.push_back(pattern);
+    return false;
+  });
+  std::sort(matched.begin(), matched.end());
+  matched.erase(std::unique(matched.begin(), matched.end()), matched.end());
+  matched.erase(std::remove_if(matched.begin(), matched.end(),
+                               [this, candidate](size_t pattern) {
+                                 return !matchers_[pattern](candidate);
+                               }),
+                matched.end());
+}
+
+void PatternSet::match(const Item &candidate,
+                       std::vector<size_t> &matched) const {
+  match(candidate.filename, matched);
+}
+
+bool PatternSet::matchAny(CStringView candidate) const {
+  if (nodes_.empty())
+    return false;
+  return forEachCandidate(candidate, [this, candidate](size_t pattern) {
+    return matchers_[pattern](candidate);
+  });
+}
+
+} // namespace sequence
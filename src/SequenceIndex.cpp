@@ -0,0 +1,249 @@
+#include "sequence/SequenceIndex.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include "sequence/details/ParserUtils.hpp"
+#include "sequence/details/StringUtils.hpp"
+#include "sequence/details/Utils.hpp"
+
+using namespace sequence::details;
+
+namespace sequence {
+
+namespace {
+
+typedef std::map<Index, Index> RangeMap;
+
+// Returns the range containing value or end.
+RangeMap::const_iterator findRange(const RangeMap &ranges, Index value) {
+  auto itr = ranges.upper_bound(value);
+  if (itr == ranges.begin())
+    return ranges.end();
+  --itr;
+  return itr->second >= value ? itr : ranges.end();
+}
+
+bool addToRanges(RangeMap &ranges, Index value) {
+  if (findRange(ranges, value) != ranges.end())
+    return false;
+  auto next = ranges.upper_bound(value);
+  const bool joinNext = next != ranges.end() && next->first == value + 1;
+  if (next != ranges.begin()) {
+    auto previous = std::prev(next);
+    if (previous->second + 1 == value) { // joining previous range
+      previous->second = joinNext ? next->second : value;
+      if (joinNext)
+        ranges.erase(next);
+      return true;
+    }
+  }
+  if (joinNext) {
+    const Index end = next->second;
+    ranges.erase(next);
+    ranges.emplace(value, end);
+  } else {
+    ranges.emplace(value, value);
+  }
+  return true;
+}
+
+bool removeFromRanges(RangeMap &ranges, Index value) {
+  auto itr = ranges.upper_bound(value);
+  if (itr == ranges.begin())
+    return false;
+  --itr;
+  const Index start = itr->first, end = itr->second;
+  if (end < value)
+    return false;
+  // Splitting the range around value.
+  ranges.erase(itr);
+  if (start < value)
+    ranges.emplace(start, value - 1);
+  if (value < end)
+    ranges.emplace(value + 1, end);
+  return true;
+}
+
+// Items in a but not in b.
+Items difference(const Items &a, const Items &b) {
+  Items output;
+  std::set_difference(std::begin(a), std::end(a), std::begin(b), std::end(b),
+                      std::back_inserter(output));
+  return output;
+}
+
+} // namespace
+
+std::string SequenceIndex::normalize(CStringView filename,
+                                     std::string &pattern, Indices &indices) {
+  pattern = filename.toString();
+  extractFileIndicesAndNormalize(pattern, indices);
+  if (!CStringView(pattern).contains(PADDING_CHAR))
+    return pattern;
+  CStringView prefix, suffix;
+  std::tie(prefix, suffix) = getInternalPrefixAndSuffix(pattern);
+  return concat(prefix, "#", suffix);
+}
+
+bool SequenceIndex::add(CStringView filename) {
+  std::string pattern;
+  Indices indices;
+  const std::string key = normalize(filename, pattern, indices);
+  Group &group = groups[key];
+  Sequence &sequence = group.sequences[std::make_pair(pattern, indices.size())];
+  bool added;
+  if (indices.empty()) {
+    added = !sequence.present;
+    sequence.present = true;
+  } else if (indices.size() == 1) {
+    added = addToRanges(sequence.ranges, indices[0]);
+  } else {
+    added = sequence.rows.insert(std::move(indices)).second;
+  }
+  if (added) {
+    group.dirty = true;
+    ++fileCount;
+  }
+  return added;
+}
+
+bool SequenceIndex::remove(CStringView filename) {
+  std::string pattern;
+  Indices indices;
+  const auto group = groups.find(normalize(filename, pattern, indices));
+  if (group == groups.end())
+    return false;
+  const auto sequence =
+      group->second.sequences.find(std::make_pair(pattern, indices.size()));
+  if (sequence == group->second.sequences.end())
+    return false;
+  Sequence &current = sequence->second;
+  bool removed;
+  if (indices.empty()) {
+    removed = current.present;
+    current.present = false;
+  } else if (indices.size() == 1) {
+    removed = removeFromRanges(current.ranges, indices[0]);
+  } else {
+    removed = current.rows.erase(indices) > 0;
+  }
+  if (removed) {
+    group->second.dirty = true;
+    --fileCount;
+    if (current.empty())
+      group->second.sequences.erase(sequence);
+  }
+  return removed;
+}
+
+bool SequenceIndex::contains(CStringView filename) const {
+  std::string pattern;
+  Indices indices;
+  const auto group = groups.find(normalize(filename, pattern, indices));
+  if (group == groups.end())
+    return false;
+  const auto sequence =
+      group->second.sequences.find(std::make_pair(pattern, indices.size()));
+  if (sequence == group->second.sequences.end())
+    return false;
+  const Sequence &current = sequence->second;
+  if (indices.empty())
+    return current.present;
+  if (indices.size() == 1)
+    return findRange(current.ranges, indices[0]) != current.ranges.end();
+  return current.rows.count(indices) > 0;
+}
+
+// Mirrors parse for the sequences of a single group.
+void SequenceIndex::compute(Group &group) const {
+  const bool canMerge =
+      configuration.mergePadding && group.sequences.size() >= 2;
+  Buckets buckets;
+  SplitBuckets packed;
+  for (const auto &pair : group.sequences) {
+    const std::string &pattern = pair.first.first;
+    const size_t columns = pair.first.second;
+    const Sequence &sequence = pair.second;
+    Bucket bucket(pattern);
+    if (columns == 1) {
+      const auto &ranges = sequence.ranges;
+      const bool hasRun =
+          std::any_of(std::begin(ranges), std::end(ranges),
+                      [](const std::pair<const Index, Index> &range) {
+                        return range.first != range.second;
+                      });
+      if (configuration.pack && hasRun && !canMerge) {
+        // Frames are contiguous, ranges are already packed.
+        SplitBucket split;
+        split.pattern = pattern;
+        split.step = 1;
+        for (const auto &range : ranges)
+          split.ranges.emplace_back(range.first, range.second);
+        packed.push_back(std::move(split));
+        continue;
+      }
+      bucket.columns.resize(1);
+      for (const auto &range : ranges)
+        for (uint64_t i = range.first; i <= range.second; ++i)
+          bucket.columns[0].push_back(Index(i));
+    } else if (columns > 1) {
+      for (const Indices &row : sequence.rows)
+        bucket.ingest(row);
+    }
+    buckets.push_back(std::move(bucket));
+  }
+  auto splitBuckets = splitAllAndSort(
+      configuration.getPivotIndex, std::move(buckets),
+      configuration.detectGrids);
+  if (configuration.mergePadding && splitBuckets.size() >= 2) {
+    mergeCompatiblePadding(splitBuckets);
+  }
+  if (configuration.pack) {
+    for (auto &bucket : splitBuckets) {
+      bucket.pack();
+    }
+  }
+  std::move(std::begin(packed), std::end(packed),
+            std::back_inserter(splitBuckets));
+  group.items.clear();
+  for (auto &bucket : splitBuckets) {
+    bucket.output(configuration.bakeSingleton, [&group](Item item) {
+      group.items.push_back(std::move(item));
+    });
+  }
+  std::sort(std::begin(group.items), std::end(group.items));
+  group.dirty = false;
+}
+
+Items SequenceIndex::snapshot() {
+  update([](const Items &, const Items &) {});
+  Items items;
+  for (const auto &pair : groups) {
+    const Items &current = pair.second.items;
+    items.insert(std::end(items), std::begin(current), std::end(current));
+  }
+  std::sort(std::begin(items), std::end(items));
+  return items;
+}
+
+void SequenceIndex::update(
+    std::function<void(const Items &removed, const Items &added)> onChange) {
+  for (auto itr = groups.begin(); itr != groups.end();) {
+    Group &group = itr->second;
+    if (group.dirty) {
+      const Items previous = std::move(group.items);
+      compute(group);
+      const Items removed = difference(previous, group.items);
+      const Items added = difference(group.items, previous);
+      if (!removed.empty() || !added.empty())
+        onChange(removed, added);
+    }
+    if (group.sequences.empty())
+      itr = groups.erase(itr);
+    else
+      ++itr;
+  }
+}
+
+} // namespace sequence
@@ -0,0 +1,174 @@
+#include "sequence/Stats.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <string>
+#include <thread>
+
+#if defined(_WIN64) || defined(_WIN32)
+#include <sys/stat.h>
+#include <sys/types.h>
+#elif defined(__APPLE__) || defined(__linux)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <sequence/Filenames.hpp>
+
+namespace sequence {
+
+namespace {
+
+// Number of files stat'ed by a task.
+const size_t BATCH_SIZE = 1024;
+
+#if defined(_WIN64) || defined(_WIN32)
+struct Directory {
+  std::string path;
+
+  Directory(CStringView foldername) : path(foldername.toString()) {}
+
+  bool opened() const {
+    struct _stat64 stats;
+    return _stat64(path.c_str(), &stats) == 0 && (stats.st_mode & _S_IFDIR);
+  }
+
+  bool stat(const char *filename, uint64_t &size, int64_t &mtime) const {
+    struct _stat64 stats;
+    if (_stat64((path + '\\' + filename).c_str(), &stats) != 0)
+      return false;
+    size = stats.st_size;
+    mtime = int64_t(stats.st_mtime) * 1000000000;
+    return true;
+  }
+};
+#elif defined(__APPLE__) || defined(__linux)
+// Files are stat'ed relative to the directory to save path lookups.
+struct Directory {
+  int fd;
+
+  Directory(CStringView foldername)
+      : fd(open(foldername.toString().c_str(), O_RDONLY | O_DIRECTORY)) {}
+  ~Directory() {
+    if (fd >= 0)
+      close(fd);
+  }
+
+  bool opened() const { return fd >= 0; }
+
+#if defined(__linux) && defined(STATX_SIZE)
+  bool stat(const char *filename, uint64_t &size, int64_t &mtime) const {
+    // Network filesystems may skip synchronizing the other attributes.
+    struct statx stats;
+    if (statx(fd, filename, AT_STATX_DONT_SYNC, STATX_SIZE | STATX_MTIME,
+              &stats) != 0)
+      return false;
+    size = stats.stx_size;
+    mtime = int64_t(stats.stx_mtime.tv_sec) * 1000000000 +
+            stats.stx_mtime.tv_nsec;
+    return true;
+  }
+#else
+  bool stat(const char *filename, uint64_t &size, int64_t &mtime) const {
+    struct stat stats;
+    if (fstatat(fd, filename, &stats, 0) != 0)
+      return false;
+    size = stats.st_size;
+    mtime = int64_t(stats.st_mtime) * 1000000000;
+    return true;
+  }
+#endif
+};
+#else
+#error "Unsupported platform"
+#endif
+
+struct Batch {
+  size_t item, first, count;
+  ItemStats stats;
+};
+
+} // namespace
+
+void ItemStats::add(Index frame, uint64_t size, int64_t mtime) {
+  ++files;
+  bytes += size;
+  minMtime = std::min(minMtime, mtime);
+  maxMtime = std::max(maxMtime, mtime);
+  if (size < smallestSize) {
+    smallestSize = size;
+    smallestFrame = frame;
+  }
+  if (size > largestSize || files == 1) {
+    largestSize = size;
+    largestFrame = frame;
+  }
+}
+
+void ItemStats::merge(const ItemStats &other) {
+  if (other.files > 0) {
+    if (other.smallestSize < smallestSize) {
+      smallestSize = other.smallestSize;
+      smallestFrame = other.smallestFrame;
+    }
+    if (other.largestSize > largestSize || files == 0) {
+      largestSize = other.largestSize;
+      largestFrame = other.largestFrame;
+    }
+  }
+  files += other.files;
+  missing += other.missing;
+  bytes += other.bytes;
+  minMtime = std::min(minMtime, other.minMtime);
+  maxMtime = std::max(maxMtime, other.maxMtime);
+}
+
+std::vector<ItemStats> getItemsStats(CStringView foldername,
+                                     const Items &items) {
+  const Directory directory(foldername);
+  if (!directory.opened())
+    return {};
+  // Large sequences are split so their files are stat'ed concurrently.
+  std::vector<Batch> batches;
+  for (size_t i = 0; i < items.size(); ++i) {
+    const size_t count = countFilenames(items[i]);
+    for (size_t first = 0; first < count; first += BATCH_SIZE) {
+      const size_t size = std::min(BATCH_SIZE, count - first);
+      batches.push_back({i, first, size, ItemStats()});
+    }
+  }
+  std::atomic<size_t> next(0);
+  const auto work = [&]() {
+    for (size_t i; (i = next++) < batches.size();) {
+      Batch &batch = batches[i];
+      const Item &item = items[batch.item];
+      for (auto itr = FilenameIterator(item, batch.first, batch.count);
+           itr != FilenameIterator(); ++itr) {
+        uint64_t size;
+        int64_t mtime;
+        if (directory.stat((*itr).ptr(), size, mtime))
+          batch.stats.add(itr.frame(), size, mtime);
+        else
+          ++batch.stats.missing;
+      }
+    }
+  };
+  const size_t threads =
+      std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1U) * 2,
+                       batches.size());
+  std::vector<std::future<void>> futures;
+  for (size_t i = 1; i < threads; ++i)
+    futures.push_back(std::async(std::launch::async, work));
+  work();
+  for (auto &future : futures)
+    future.get();
+  // Batches of an Item are merged in order, the first extreme frame wins.
+  std::vector<ItemStats> stats(items.size());
+  for (const Batch &batch : batches)
+    stats[batch.item].merge(batch.stats);
+  return stats;
+}
+
+} // namespace sequence
@@ -3,6 +3,8 @@
 #include <cassert>
 
 #include <algorithm>
+#include <array>
+#include <vector>
 
 #include <sequence/details/StringUtils.hpp>
 
@@ -79,11 +81,172 @@ Item createSequence(CStringView pattern, Indices indices) {
   return Item(pattern, std::move(indices));
 }
 
-std::regex getMatcher(CStringView pattern, bool ignoreCase) {
-  auto flags = std::regex_constants::ECMAScript;
-  if (ignoreCase)
-    flags |= std::regex_constants::icase;
-  return std::regex(details::getMatcherString(pattern.toString()), flags);
+Item createGrid(CStringView pattern, Item::Extents extents) {
+  size_t runs = 0;
+  for (size_t i = 0; i < pattern.size(); ++i)
+    if (pattern[i] == PADDING_CHAR &&
+        (i == 0 || pattern[i - 1] != PADDING_CHAR))
+      ++runs;
+  if (runs != extents.size())
+    throw std::invalid_argument("Pattern must have one padding per extent");
+  for (const Item::Extent &extent : extents)
+    if (extent.start > extent.end)
+      throw std::invalid_argument("Invalid extent");
+  Item item(pattern);
+  item.extents = std::move(extents);
+  return item;
+}
+
+namespace {
+
+void appendIndex(std::string &output, Index value) {
+  char digits[10]; // 4,294,967,295 is 10 characters long maximum.
+  char *end = digits + sizeof(digits), *begin = end;
+  do {
+    *--begin = '0' + value % 10;
+    value /= 10;
+  } while (value);
+  output.append(begin, end);
+}
+
+size_t countDigits(Index value) {
+  return 1 + (value >= 10) + (value >= 100) + (value >= 1000) +
+         (value >= 10000) + (value >= 100000) + (value >= 1000000) +
+         (value >= 10000000) + (value >= 100000000) + (value >= 1000000000);
+}
+
+void appendRange(std::string &output, Index start, Index end, Index step) {
+  if (!output.empty())
+    output += ',';
+  appendIndex(output, start);
+  if (start == end)
+    return;
+  // Two frames are best written as two single frames.
+  output += end - start == step ? ',' : '-';
+  appendIndex(output, end);
+  if (end - start != step && step != 1) {
+    output += 'x';
+    appendIndex(output, step);
+  }
+}
+
+} // namespace
+
+FrameRanges parseFrameRanges(CStringView spec) {
+  FrameRanges ranges;
+  parseFrameSpec(spec, [&ranges](const FrameRange &range) {
+    ranges.push_back(range);
+  });
+  return ranges;
+}
+
+Indices parseFrameSpec(CStringView spec) {
+  Indices indices;
+  parseFrameSpec(spec, [&indices](const FrameRange &range) {
+    for (uint64_t i = range.start; i <= range.end; i += range.step)
+      indices.push_back(Index(i));
+  });
+  return indices;
+}
+
+// Each position starts either a single frame or a run of constant step which
+// can only end at the end of the longest such run or right before it (leaving
+// its last frame to the next run). Dynamic programming over these choices
+// gives the shortest spec in linear time. Only the choices are stored, runs are
+// found again when writing the spec.
+std::string formatFrameSpec(const Indices &indices) {
+  enum Choice : uint8_t { SINGLE, RUN, RUN_BUT_LAST };
+  const size_t size = indices.size();
+  if (size == 0)
+    return {};
+  const auto sameStep = [&indices](size_t i) {
+    return indices[i + 2] - indices[i + 1] == indices[i + 1] - indices[i];
+  };
+  std::vector<Choice> choices(size);
+  // Shortest spec lengths (with trailing ',') for suffixes starting at i + 1,
+  // i + 2, runEnd and runEnd + 1.
+  size_t next = 0, nextNext = 0, atRunEnd = 0, afterRunEnd = 0;
+  // Lengths of "-end,", "-end-1," and "xstep" for the current run.
+  size_t runEndSuffix = 0, runButLastSuffix = 0, stepSuffix = 0;
+  size_t runEnd = size - 1;
+  // Indices are decreasing so their digit count is maintained incrementally.
+  size_t startDigits = countDigits(indices.back());
+  Index startLowest = 1;
+  for (size_t digits = startDigits; digits > 1; --digits)
+    startLowest *= 10;
+  for (size_t i = size; i-- > 0;) {
+    for (; startDigits > 1 && indices[i] < startLowest; startLowest /= 10)
+      --startDigits;
+    if (i + 2 >= size || !sameStep(i)) {
+      runEnd = i + 1;
+      atRunEnd = next;
+      afterRunEnd = nextNext;
+      if (runEnd < size) {
+        const Index step = indices[runEnd] - indices[i];
+        runEndSuffix = 2 + countDigits(indices[runEnd]);
+        runButLastSuffix = 2 + countDigits(indices[i]);
+        stepSuffix = step == 1 ? 0 : 1 + countDigits(step);
+      }
+    } else if (runEnd == i + 2) {
+      runButLastSuffix = 2 + countDigits(indices[i + 1]);
+    }
+    size_t length = startDigits + 1 + next;
+    Choice choice = SINGLE;
+    if (runEnd >= i + 2) {
+      // On ties, ranges are preferred over single frames.
+      const size_t run = startDigits + runEndSuffix + stepSuffix + afterRunEnd;
+      if (run <= length) {
+        length = run;
+        choice = RUN;
+      }
+      if (runEnd >= i + 3) {
+        const size_t runButLast =
+            startDigits + runButLastSuffix + stepSuffix + atRunEnd;
+        if (runButLast < length) {
+          length = runButLast;
+          choice = RUN_BUT_LAST;
+        }
+      }
+    }
+    choices[i] = choice;
+    nextNext = next;
+    next = length;
+  }
+  std::string output;
+  output.reserve(next);
+  runEnd = 0;
+  for (size_t i = 0; i < size;) {
+    if (choices[i] == SINGLE) {
+      appendRange(output, indices[i], indices[i], 1);
+      ++i;
+      continue;
+    }
+    if (i >= runEnd)
+      for (runEnd = i + 1; runEnd + 1 < size && sameStep(runEnd - 1);)
+        ++runEnd;
+    const size_t end = choices[i] == RUN ? runEnd : runEnd - 1;
+    appendRange(output, indices[i], indices[end], indices[i + 1] - indices[i]);
+    i = end + 1;
+  }
+  return output;
+}
+
+std::string formatFrameRanges(const FrameRanges &ranges) {
+  std::string output;
+  for (const FrameRange &range : ranges) {
+    // Making sure end is the last frame of the range.
+    const Index end = range.end - (range.end - range.start) % range.step;
+    appendRange(output, range.start, end, range.step);
+  }
+  return output;
+}
+
+Matcher getMatcher(CStringView pattern, bool ignoreCase) {
+  return Matcher(pattern, ignoreCase);
+}
+
+bool match(const Matcher &matcher, const Item &candidate) {
+  return matcher(candidate.filename);
 }
 
 bool match(const std::regex &matcher, const Item &candidate) {
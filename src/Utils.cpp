@@ -2,13 +2,23 @@
 
 #include <cassert>
 #include <cmath>
+#include <cstdio>
 #include <cstring>
 
 #include <algorithm>
 #include <bitset>
+#include <fstream>
 #include <set>
+#include <string>
 #include <utility>
 
+#if defined(_WIN64) || defined(_WIN32)
+#include <Windows.h>
+#include <process.h>
+#elif defined(__APPLE__) || defined(__linux)
+#include <unistd.h>
+#endif
+
 #include "sequence/Tools.hpp"
 #include "sequence/details/Hash.hpp"
 #include "sequence/details/StringView.hpp"
@@ -115,6 +125,110 @@ void Bucket::ingest(const Indices &indices) {
   }
 }
 
+void Bucket::ingest(Index index) {
+  if (columns.empty()) {
+    columns.resize(1);
+  }
+  assert(columns.size() == 1);
+  if (!ingestRange(index)) {
+    columns[0].push_back(index);
+  }
+}
+
+// Ranges are worth keeping if they hold at least 4 indices on average.
+enum : size_t { MIN_RANGES_TO_CHECK = 32, MIN_AVERAGE_RANGE_SIZE = 4 };
+
+bool Bucket::ingestRange(Index value) {
+  if (step == 0) { // ranges were dropped
+    return false;
+  }
+  if (ranges.empty()) {
+    Indices &column = columns[0];
+    if (column.empty()) { // first index is stored as is
+      return false;
+    }
+    assert(column.size() == 1);
+    const Index first = column[0];
+    if (value <= first ||
+        value - first >= Index(std::numeric_limits<char>::max())) {
+      step = 0;
+      return false;
+    }
+    step = value - first;
+    ranges.emplace_back(first, value);
+    rangesCount = 2;
+    column.clear();
+    return true;
+  }
+  if (!insertRange(value)) {
+    dropRanges();
+    return false;
+  }
+  ++rangesCount;
+  if (ranges.size() > MIN_RANGES_TO_CHECK &&
+      ranges.size() * MIN_AVERAGE_RANGE_SIZE > rangesCount) {
+    dropRanges();
+  }
+  return true;
+}
+
+// Ranges are sorted, each range going by step and the gap between two ranges
+// being larger than step. Returns false if value breaks this invariant.
+bool Bucket::insertRange(Index value) {
+  const Index s = step;
+  if (value > ranges.back().end) { // fast path for increasing indices
+    const Index gap = value - ranges.back().end;
+    if (gap < s) {
+      return false;
+    }
+    if (gap == s) {
+      ranges.back().end = value;
+    } else {
+      ranges.emplace_back(value, value);
+    }
+    return true;
+  }
+  // Finding the first range starting after value.
+  const auto next = std::upper_bound(
+      std::begin(ranges), std::end(ranges), value,
+      [](const Index value, const Range &range) { return value < range.start; });
+  const bool hasPrevious = next != std::begin(ranges);
+  const auto previous = hasPrevious ? std::prev(next) : next;
+  if (hasPrevious && value <= previous->end) { // duplicate or smaller step
+    return false;
+  }
+  assert(next != std::end(ranges));
+  const Index previousGap = hasPrevious ? value - previous->end : s + 1;
+  const Index nextGap = next->start - value;
+  if (previousGap < s || nextGap < s) {
+    return false;
+  }
+  if (previousGap == s && nextGap == s) {
+    previous->end = next->end;
+    ranges.erase(next);
+  } else if (previousGap == s) {
+    previous->end = value;
+  } else if (nextGap == s) {
+    next->start = value;
+  } else {
+    ranges.insert(next, Range(value, value));
+  }
+  return true;
+}
+
+void Bucket::dropRanges() {
+  Indices &column = columns[0];
+  column.reserve(rangesCount);
+  for (const Range &range : ranges) {
+    for (uint64_t value = range.start; value <= range.end; value += step) {
+      column.push_back(Index(value));
+    }
+  }
+  ranges = Ranges();
+  rangesCount = 0;
+  step = 0;
+}
+
 bool Bucket::single() const {
   return !columns.empty() && columns[0].size() == 1;
 }
@@ -167,7 +281,10 @@ SplitBucket::SplitBucket(Bucket &&bucket) {
   assert(!bucket.splittable());
   pattern = std::move(bucket.pattern);
   assert(bucket.columns.size() <= 1);
-  if (bucket.columns.size() == 1) {
+  if (!bucket.ranges.empty()) { // already packed during ingestion
+    ranges = std::move(bucket.ranges);
+    step = bucket.step;
+  } else if (bucket.columns.size() == 1) {
     sortedIndices = std::move(bucket.columns[0]);
     std::sort(std::begin(sortedIndices), std::end(sortedIndices));
   }
@@ -195,7 +312,8 @@ bool SplitBucket::containsPadding() const {
 }
 
 bool SplitBucket::canMerge(const SplitBucket &other) const {
-  if (!containsPadding() || !other.containsPadding() ||
+  if (!extents.empty() || !other.extents.empty() || !containsPadding() ||
+      !other.containsPadding() ||
       getInternalPrefixAndSuffix(pattern) !=
           getInternalPrefixAndSuffix(other.pattern)) {
     return false;
@@ -217,6 +335,48 @@ std::string SplitBucket::getBakedPattern(Index value) const {
   return concat(prefix, view, suffix);
 }
 
+bool getGrid(const Bucket &bucket, SplitBucket &grid) {
+  assert(bucket.splittable());
+  const size_t rows = bucket.columns[0].size();
+  Ranges bounds;
+  std::vector<size_t> varying;
+  uint64_t combinations = 1;
+  for (size_t i = 0; i < bucket.columns.size(); ++i) {
+    const auto minmax = std::minmax_element(std::begin(bucket.columns[i]),
+                                            std::end(bucket.columns[i]));
+    bounds.emplace_back(*minmax.first, *minmax.second);
+    if (*minmax.first == *minmax.second)
+      continue;
+    varying.push_back(i);
+    combinations *= uint64_t(*minmax.second) - *minmax.first + 1;
+    if (combinations > rows)
+      return false;
+  }
+  if (varying.size() < 2 || combinations != rows)
+    return false;
+  // As many rows as combinations, the grid is full if no row is repeated.
+  std::vector<bool> seen(rows);
+  for (size_t row = 0; row < rows; ++row) {
+    uint64_t position = 0;
+    for (const size_t i : varying) {
+      const Range &range = bounds[i];
+      position = position * (uint64_t(range.end) - range.start + 1) +
+                 (bucket.columns[i][row] - range.start);
+    }
+    if (seen[position])
+      return false;
+    seen[position] = true;
+  }
+  grid.pattern = bucket.pattern;
+  for (size_t i = bucket.columns.size(); i-- > 0;)
+    if (bounds[i].start == bounds[i].end)
+      bake(grid.pattern, i, bounds[i].start);
+  grid.extents.clear();
+  for (const size_t i : varying)
+    grid.extents.push_back(bounds[i]);
+  return true;
+}
+
 char getStep(Indices sortedIndices) {
   bool minimum_step_set = false;
   size_t minimum_step = std::numeric_limits<char>::max();
@@ -243,6 +403,9 @@ template <typename Itr> Itr findRangeEnd(Itr first, Itr last, size_t step) {
 }
 
 void SplitBucket::pack() {
+  if (!ranges.empty()) { // already packed during ingestion
+    return;
+  }
   step = getStep(sortedIndices);
   if (step > 0) {
     auto rangeStart = std::begin(sortedIndices);
@@ -257,8 +420,23 @@ void SplitBucket::pack() {
   }
 }
 
+void SplitBucket::unpack() {
+  for (const Range &range : ranges) {
+    for (uint64_t value = range.start; value <= range.end; value += step) {
+      sortedIndices.push_back(Index(value));
+    }
+  }
+  ranges.clear();
+  step = -1;
+}
+
 void SplitBucket::output(bool bakeSingleton, std::function<void(Item)> push) {
-  if (ranges.size()) { // PACKED items
+  if (!extents.empty()) { // GRID items
+    Item::Extents values;
+    for (const Range &extent : extents)
+      values.push_back({extent.start, extent.end});
+    push(createGrid(pattern, std::move(values)));
+  } else if (ranges.size()) { // PACKED items
     for (const auto range : ranges) {
       if (range.start == range.end && bakeSingleton) {
         push(createSingleFile(getBakedPattern(range.start)));
@@ -294,7 +472,11 @@ Bucket &FileBucketizer::getOrAdd(CStringView bucket, uint32_t seed) {
 Bucket &FileBucketizer::ingest(StringView filename) {
   extractFileIndicesAndNormalize(filename, tmp);
   auto &bucket = getOrAdd(filename, tmp.size());
-  bucket.ingest(tmp);
+  if (tmp.size() == 1) {
+    bucket.ingest(tmp[0]);
+  } else {
+    bucket.ingest(tmp);
+  }
   return bucket;
 }
 
@@ -308,5 +490,33 @@ std::vector<Bucket> FileBucketizer::transfer() {
   return dst;
 }
 
+bool replaceFile(const std::string &filename, const std::string &content) {
+#if defined(_WIN64) || defined(_WIN32)
+  const int pid = _getpid();
+#else
+  const int pid = getpid();
+#endif
+  // Unique per process so concurrent writers do not share it.
+  const std::string temporary = filename + '.' + std::to_string(pid) + ".tmp";
+  {
+    std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+    stream.write(content.data(), content.size());
+    if (!stream.flush()) {
+      stream.close();
+      std::remove(temporary.c_str());
+      return false;
+    }
+  }
+#if defined(_WIN64) || defined(_WIN32)
+  const bool renamed = MoveFileExA(temporary.c_str(), filename.c_str(),
+                                   MOVEFILE_REPLACE_EXISTING);
+#else
+  const bool renamed = std::rename(temporary.c_str(), filename.c_str()) == 0;
+#endif
+  if (!renamed)
+    std::remove(temporary.c_str());
+  return renamed;
+}
+
 } // namespace details
 } // namespace sequence
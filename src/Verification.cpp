@@ -0,0 +1,127 @@
+#include "sequence/Verification.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace sequence {
+
+namespace {
+
+// Parses the frame of a filename made of prefix, digits and suffix.
+// Returns false if the digits are not a valid frame for padding.
+bool parseFrame(const char *begin, const char *end, size_t padding,
+                Index &frame) {
+  const size_t digits = end - begin;
+  if (digits == 0 || digits < padding || (digits > padding && *begin == '0'))
+    return false;
+  uint64_t value = 0;
+  for (const char *itr = begin; itr != end; ++itr) {
+    if (*itr < '0' || *itr > '9')
+      return false;
+    value = value * 10 + (*itr - '0');
+    if (value > std::numeric_limits<Index>::max())
+      return false;
+  }
+  frame = Index(value);
+  return true;
+}
+
+// Appends frame to ranges, extending the last range if frame follows it.
+void append(FrameRanges &ranges, Index frame, Index step) {
+  if (!ranges.empty() && uint64_t(ranges.back().end) + step == frame)
+    ranges.back().end = frame;
+  else
+    ranges.emplace_back(frame, frame, step);
+}
+
+// Gathers the frames of pattern from entries, one at a time.
+struct Verifier {
+  Verifier(CStringView pattern, const FrameRange &range)
+      : start(range.start), end(range.end),
+        step(std::max<Index>(range.step, 1)) {
+    if (range.start > range.end)
+      throw std::invalid_argument("Invalid frame range");
+    const auto pair = getPrefixAndSuffix(pattern);
+    prefix = pair.first;
+    suffix = pair.second;
+    padding = pattern.size() - prefix.size() - suffix.size();
+    count = (end - start) / step + 1;
+    present.resize((count + 63) / 64);
+  }
+
+  void ingest(const FilesystemEntry &entry) {
+    const StringView name = entry.filename;
+    if (entry.isDirectory || name.size() <= prefix.size() + suffix.size() ||
+        memcmp(name.begin(), prefix.begin(), prefix.size()) != 0 ||
+        memcmp(name.end() - suffix.size(), suffix.begin(), suffix.size()) != 0)
+      return;
+    Index frame;
+    if (!parseFrame(name.begin() + prefix.size(), name.end() - suffix.size(),
+                    padding, frame))
+      return;
+    const Index offset = frame - start;
+    if (frame < start || frame > end || offset % step != 0) {
+      extra.push_back(frame);
+      return;
+    }
+    const uint64_t bit = offset / step;
+    present[bit / 64] |= uint64_t(1) << (bit % 64);
+  }
+
+  Verification finish() {
+    Verification output;
+    for (size_t word = 0; word < present.size(); ++word) {
+      uint64_t absent = ~present[word];
+      if (word + 1 == present.size() && count % 64 != 0)
+        absent &= (uint64_t(1) << (count % 64)) - 1;
+      for (; absent; absent &= absent - 1) {
+        const uint64_t bit = word * 64 + __builtin_ctzll(absent);
+        append(output.missing, Index(start + bit * step), step);
+      }
+    }
+    std::sort(extra.begin(), extra.end());
+    for (const Index frame : extra)
+      append(output.extra, frame, 1);
+    return output;
+  }
+
+private:
+  const Index start, end, step;
+  CStringView prefix, suffix;
+  size_t padding;
+  uint64_t count;
+  std::vector<uint64_t> present; // one bit per expected frame
+  Indices extra;
+};
+
+} // namespace
+
+Verification verifyEntries(CStringView pattern, const FrameRange &range,
+                           GetNextEntryFunction getNextEntry) {
+  Verifier verifier(pattern, range);
+  FilesystemEntry entry;
+  while (getNextEntry(entry))
+    verifier.ingest(entry);
+  return verifier.finish();
+}
+
+bool verifySequence(CStringView pattern, const FrameRange &range,
+                    Verification &output) {
+  const size_t slash = pattern.lastIndexOf('/');
+  std::string directory = ".";
+  if (slash != CStringView::npos)
+    directory = pattern.substr(0, std::max<size_t>(slash, 1)).toString();
+  Verifier verifier(
+      slash != CStringView::npos ? pattern.substr(slash + 1) : pattern, range);
+  if (!listDir(directory, [&verifier](const FilesystemEntry &entry) {
+        verifier.ingest(entry);
+      }))
+    return false;
+  output = verifier.finish();
+  return true;
+}
+
+} // namespace sequence
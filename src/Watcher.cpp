@@ -0,0 +1,250 @@
+#include "sequence/Watcher.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+
+#if defined(__linux)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sequence {
+
+namespace {
+
+// Items in a but not in b.
+Items difference(const Items &a, const Items &b) {
+  Items output;
+  std::set_difference(std::begin(a), std::end(a), std::begin(b), std::end(b),
+                      std::back_inserter(output));
+  return output;
+}
+
+void append(Items &output, const Items &items) {
+  output.insert(std::end(output), std::begin(items), std::end(items));
+}
+
+#if defined(__linux)
+enum : uint32_t {
+  WATCH_MASK = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+               IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR
+};
+#endif
+
+} // namespace
+
+Watcher::Watcher(const Configuration &configuration)
+    : configuration(configuration) {
+#if defined(__linux)
+  inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+Watcher::~Watcher() {
+#if defined(__linux)
+  if (inotifyFd >= 0)
+    close(inotifyFd);
+#endif
+}
+
+Watcher::Folder Watcher::list(const std::string &path, bool &listed) const {
+  Folder folder(configuration);
+  folder.path = path;
+  listed = listDir(path, [this, &folder](const FilesystemEntry &entry) {
+    if (!acceptEntry(configuration, entry))
+      return;
+    if (entry.isDirectory)
+      folder.directories.insert(entry.filename.toString());
+    else
+      folder.files.add(entry.filename);
+  });
+  return folder;
+}
+
+bool Watcher::watch(const std::string &path, bool recursive) {
+#if defined(__linux)
+  if (inotifyFd < 0 || watchers.count(path))
+    return false;
+  // Watching first so no event is lost while listing.
+  const int wd = inotify_add_watch(inotifyFd, path.c_str(), WATCH_MASK);
+  if (wd < 0)
+    return false;
+  bool listed;
+  Folder folder = list(path, listed);
+  if (!listed) {
+    inotify_rm_watch(inotifyFd, wd);
+    return false;
+  }
+  folder.files.snapshot();
+  folder.recursive = recursive;
+  folders.emplace(wd, std::move(folder));
+  watchers[path] = wd;
+  return true;
+#else
+  (void)path;
+  (void)recursive;
+  return false;
+#endif
+}
+
+size_t Watcher::watchCreated(const std::string &path,
+                             ChangeFunction &onChange) {
+  if (!watch(path, true))
+    return 0;
+  Folder &folder = folders.at(watchers.at(path));
+  size_t changed = 0;
+  SequenceChange change;
+  change.folder = path;
+  change.added = folder.files.snapshot();
+  if (!change.added.empty()) {
+    ++changed;
+    onChange(change);
+  }
+  // Subdirectories may have been created before the watch was added.
+  const std::set<std::string> directories = folder.directories;
+  for (const std::string &directory : directories)
+    if (directory != "." && directory != "..")
+      changed += watchCreated(path + '/' + directory, onChange);
+  return changed;
+}
+
+void Watcher::unwatch(const std::string &path) {
+  const auto itr = watchers.find(path);
+  if (itr == watchers.end())
+    return;
+#if defined(__linux)
+  inotify_rm_watch(inotifyFd, itr->second);
+#endif
+  folders.erase(itr->second);
+  watchers.erase(itr);
+}
+
+FolderContent Watcher::snapshot(const std::string &path) {
+  FolderContent content;
+  const auto itr = watchers.find(path);
+  if (itr == watchers.end())
+    return content;
+  Folder &folder = folders.at(itr->second);
+  content.name = folder.path;
+  for (const auto &directory : folder.directories)
+    content.directories.emplace_back(directory);
+  content.files = folder.files.snapshot();
+  return content;
+}
+
+size_t Watcher::poll(int timeoutMs, ChangeFunction onChange) {
+#if defined(__linux)
+  if (inotifyFd < 0)
+    return 0;
+  struct pollfd pfd = {inotifyFd, POLLIN, 0};
+  if (::poll(&pfd, 1, timeoutMs) <= 0)
+    return 0;
+  // Applying all pending events, then computing touched sequences once.
+  std::set<int> touched, gone;
+  std::vector<std::string> created; // directories of recursive folders
+  bool overflowed = false;
+  alignas(struct inotify_event) char buffer[64 * 1024];
+  struct stat stats;
+  for (;;) {
+    const ssize_t size = read(inotifyFd, buffer, sizeof(buffer));
+    if (size <= 0)
+      break;
+    for (const char *ptr = buffer; ptr < buffer + size;) {
+      const auto *event = reinterpret_cast<const struct inotify_event *>(ptr);
+      ptr += sizeof(struct inotify_event) + event->len;
+      if (event->mask & IN_Q_OVERFLOW) {
+        overflowed = true;
+        continue;
+      }
+      const auto itr = folders.find(event->wd);
+      if (itr == folders.end())
+        continue;
+      Folder &folder = itr->second;
+      if (event->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF)) {
+        gone.insert(event->wd);
+        continue;
+      }
+      std::string filename = event->name;
+      touched.insert(event->wd);
+      if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+        if (!folder.directories.erase(filename))
+          folder.files.remove(filename);
+      } else if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+        bool isDirectory = event->mask & IN_ISDIR;
+        if (!isDirectory) {
+          // Resolving symbolic links like parseDir does.
+          const std::string path = folder.path + '/' + filename;
+          if (stat(path.c_str(), &stats) != 0)
+            continue;
+          if (S_ISDIR(stats.st_mode))
+            isDirectory = true;
+          else if (!S_ISREG(stats.st_mode))
+            continue;
+        }
+        if (!acceptEntry(configuration, {filename, isDirectory}))
+          continue;
+        if (isDirectory) {
+          folder.directories.insert(filename);
+          if (folder.recursive)
+            created.push_back(folder.path + '/' + filename);
+        } else
+          folder.files.add(filename);
+      }
+    }
+  }
+  size_t changed = 0;
+  for (auto &pair : folders) {
+    if (gone.count(pair.first))
+      continue;
+    Folder &folder = pair.second;
+    SequenceChange change;
+    change.folder = folder.path;
+    if (overflowed) {
+      // Events were lost, listing the folder again.
+      const Items previous = folder.files.snapshot();
+      bool listed;
+      const bool recursive = folder.recursive;
+      folder = list(folder.path, listed);
+      folder.recursive = recursive;
+      const Items current = folder.files.snapshot();
+      change.removed = difference(previous, current);
+      change.added = difference(current, previous);
+    } else if (touched.count(pair.first)) {
+      folder.files.update([&change](const Items &removed, const Items &added) {
+        append(change.removed, removed);
+        append(change.added, added);
+      });
+    }
+    if (!change.removed.empty() || !change.added.empty()) {
+      ++changed;
+      onChange(change);
+    }
+  }
+  for (const std::string &path : created)
+    changed += watchCreated(path, onChange);
+  // Folders deleted or moved away report all their Items as removed.
+  for (const int wd : gone) {
+    const auto itr = folders.find(wd);
+    if (itr == folders.end())
+      continue;
+    SequenceChange change;
+    change.folder = itr->second.path;
+    change.removed = itr->second.files.snapshot();
+    inotify_rm_watch(inotifyFd, wd);
+    watchers.erase(itr->second.path);
+    folders.erase(itr);
+    ++changed;
+    onChange(change);
+  }
+  return changed;
+#else
+  (void)timeoutMs;
+  (void)onChange;
+  return 0;
+#endif
+}
+
+} // namespace sequence
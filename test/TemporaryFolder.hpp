@@ -0,0 +1,65 @@
+#pragma once
+
+#if defined(__linux) || defined(__APPLE__)
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+namespace sequence {
+
+// A folder created under /tmp for the duration of a test, removed with its
+// content on destruction.
+struct TemporaryFolder {
+  std::string path;
+
+  TemporaryFolder() {
+    char buffer[] = "/tmp/lss_test_XXXXXX";
+    path = mkdtemp(buffer);
+  }
+
+  ~TemporaryFolder() {
+    std::string command = "rm -rf " + path;
+    EXPECT_EQ(system(command.c_str()), 0);
+  }
+
+  std::string get(const std::string &filename) const {
+    return path + "/" + filename;
+  }
+
+  // Creates or truncates filename.
+  void touch(const std::string &filename) { write(filename, std::string()); }
+
+  void write(const std::string &filename, const std::string &content) {
+    FILE *file = fopen(get(filename).c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    fwrite(content.data(), 1, content.size(), file);
+    fclose(file);
+  }
+
+  // Returns the first line of filename or "missing".
+  std::string read(const std::string &filename) const {
+    char buffer[64] = {};
+    FILE *file = fopen(get(filename).c_str(), "r");
+    if (!file)
+      return "missing";
+    EXPECT_NE(fgets(buffer, sizeof(buffer), file), nullptr);
+    fclose(file);
+    return buffer;
+  }
+
+  // Sets the folder mtime in the past, see ScanCache.
+  void age() {
+    struct timeval times[2] = {{1000000000, 0}, {1000000000, 0}};
+    ASSERT_EQ(utimes(path.c_str(), times), 0);
+  }
+};
+
+} // namespace sequence
+
+#endif
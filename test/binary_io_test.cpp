@@ -0,0 +1,127 @@
+#include "sequence/BinaryIO.hpp"
+
+#include <cstdio>
+
+#include <gtest/gtest.h>
+
+#include <sequence/Tools.hpp>
+
+namespace sequence {
+
+namespace {
+
+FolderContent getContent() {
+  FolderContent content;
+  content.name = "/path/to/folder";
+  content.directories = {createSingleFile("a"), createSingleFile("b")};
+  content.files = {
+      createSequence("file#.jpg", 1, 100),
+      createSequence("file###.jpg", {1, 2, 3, 5, 7, 8, 4000000000}),
+      createSingleFile("readme"), createSingleFile("a"),
+      createGrid("u#_v#.####.exr", {{1, 4}, {1, 2}, {1001, 1100}})};
+  return content;
+}
+
+} // namespace
+
+TEST(BinaryIO, roundTrip) {
+  BinaryWriter writer;
+  const FolderContent original = getContent();
+  writer.add(original);
+  writer.add(FolderContent());
+  const std::string data = writer.build();
+  MappedContent content;
+  ASSERT_TRUE(content.open(data.data(), data.size()));
+  ASSERT_EQ(content.size(), 2);
+  const FolderContent read = content[0].toFolderContent();
+  EXPECT_EQ(read.name, original.name);
+  EXPECT_EQ(read.directories, original.directories);
+  EXPECT_EQ(read.files, original.files);
+  EXPECT_EQ(content[1].name, "");
+  EXPECT_EQ(content[1].fileCount, 0);
+}
+
+TEST(BinaryIO, views) {
+  BinaryWriter writer;
+  writer.add(getContent());
+  const std::string data = writer.build();
+  MappedContent content;
+  ASSERT_TRUE(content.open(data.data(), data.size()));
+  const FolderView folder = content[0];
+  EXPECT_EQ(folder.name, "/path/to/folder");
+  ASSERT_EQ(folder.directoryCount, 2);
+  ASSERT_EQ(folder.fileCount, 5);
+  const ItemView packed = folder.file(0);
+  EXPECT_EQ(packed.type, Item::PACKED);
+  EXPECT_EQ(packed.filename, "file#.jpg");
+  EXPECT_EQ(packed.start, 1);
+  EXPECT_EQ(packed.end, 100);
+  const ItemView indiced = folder.file(1);
+  EXPECT_EQ(indiced.type, Item::INDICED);
+  EXPECT_EQ(Indices(indiced.indicesBegin(), indiced.indicesEnd()),
+            Indices({1, 2, 3, 5, 7, 8, 4000000000}));
+  // Strings are shared.
+  EXPECT_EQ(folder.directory(0).filename.ptr(), folder.file(3).filename.ptr());
+}
+
+TEST(BinaryIO, compressedIndices) {
+  Indices indices;
+  for (Index i = 0; i < 100000; ++i)
+    if (i != 5000)
+      indices.push_back(i);
+  FolderContent folder;
+  folder.files.push_back(createSequence("file#.jpg", std::move(indices)));
+  BinaryWriter writer;
+  writer.add(folder);
+  EXPECT_LT(writer.build().size(), 128);
+}
+
+TEST(BinaryIO, corrupted) {
+  BinaryWriter writer;
+  writer.add(getContent());
+  std::string data = writer.build();
+  MappedContent content;
+  EXPECT_FALSE(content.open(data.data(), data.size() - 1));
+  EXPECT_FALSE(content.open(data.data(), 3));
+  data[4] = 42; // version
+  EXPECT_FALSE(content.open(data.data(), data.size()));
+}
+
+TEST(BinaryIO, gridExtents) {
+  FolderContent folder;
+  folder.files = {createGrid("u#_v#.#", {{5, 6}, {1, 2}, {1, 4294967200}})};
+  BinaryWriter writer;
+  writer.add(folder);
+  std::string data = writer.build();
+  MappedContent content;
+  ASSERT_TRUE(content.open(data.data(), data.size()));
+  EXPECT_EQ(content[0].toFolderContent().files, folder.files);
+  // An extent ending past the largest Index is rejected.
+  char &start = data[data.size() - 6]; // start of the last extent
+  ASSERT_EQ(1, start);
+  start = 0x7F;
+  EXPECT_FALSE(content.open(data.data(), data.size()));
+}
+
+TEST(BinaryIO, mappedFile) {
+  const std::string filename = "/tmp/lss_binary_io_test.lssb";
+  BinaryWriter writer;
+  writer.add(getContent());
+  ASSERT_TRUE(writer.save(filename));
+  MappedContent content;
+  ASSERT_TRUE(content.open(filename));
+  EXPECT_EQ(content[0].toFolderContent().files, getContent().files);
+  // Saving again replaces the file, the mapped one is left untouched.
+  BinaryWriter other;
+  other.add(FolderContent());
+  ASSERT_TRUE(other.save(filename));
+  EXPECT_EQ(content[0].toFolderContent().files, getContent().files);
+  content.close();
+  ASSERT_TRUE(content.open(filename));
+  EXPECT_EQ(content[0].fileCount, 0);
+  content.close();
+  std::remove(filename.c_str());
+  EXPECT_FALSE(content.open(filename));
+}
+
+} // namespace sequence
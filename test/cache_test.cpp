@@ -0,0 +1,125 @@
+#include "sequence/Cache.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <sequence/Tools.hpp>
+
+#include "TemporaryFolder.hpp"
+
+namespace sequence {
+
+TEST(ScanCache, stamp) {
+  TemporaryFolder folder;
+  DirectoryStamp a, b;
+  ASSERT_TRUE(getDirectoryStamp(folder.path, a));
+  folder.touch("file1.jpg");
+  ASSERT_TRUE(getDirectoryStamp(folder.path, b));
+  EXPECT_NE(a, b);
+  EXPECT_FALSE(getDirectoryStamp(folder.path + "/missing", a));
+}
+
+TEST(ScanCache, hitAndMiss) {
+  TemporaryFolder folder;
+  folder.touch("file1.jpg");
+  folder.touch("file2.jpg");
+  folder.age();
+  Configuration configuration;
+  configuration.pack = true;
+  ScanCache cache(configuration);
+  EXPECT_EQ(cache.parseDir(folder.path).files,
+            Items({createSequence("file#.jpg", 1, 2)}));
+  EXPECT_EQ(cache.misses, 1);
+  EXPECT_EQ(cache.parseDir(folder.path).files,
+            parseDir(configuration, folder.path).files);
+  EXPECT_EQ(cache.hits, 1);
+  folder.touch("file3.jpg");
+  EXPECT_EQ(cache.parseDir(folder.path).files,
+            Items({createSequence("file#.jpg", 1, 3)}));
+  EXPECT_EQ(cache.misses, 2);
+}
+
+TEST(ScanCache, saveAndLoad) {
+  TemporaryFolder folder;
+  folder.touch("file1.jpg");
+  folder.touch("file2.jpg");
+  folder.touch("file4.jpg");
+  folder.age();
+  const std::string filename = folder.path + ".cache";
+  Configuration configuration;
+  {
+    ScanCache cache(configuration);
+    cache.parseDir(folder.path);
+    ASSERT_TRUE(cache.save(filename));
+  }
+  ScanCache cache(configuration);
+  ASSERT_TRUE(cache.load(filename));
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(cache.parseDir(folder.path).files,
+            Items({createSequence("file#.jpg", {1, 2, 4})}));
+  EXPECT_EQ(cache.hits, 1);
+  // A different configuration invalidates the cache.
+  configuration.pack = true;
+  ScanCache other(configuration);
+  EXPECT_FALSE(other.load(filename));
+  EXPECT_EQ(other.size(), 0);
+  std::remove(filename.c_str());
+}
+
+TEST(ScanCache, saveAndLoadGrid) {
+  TemporaryFolder folder;
+  for (const char *filename : {"u1_v1.1.exr", "u1_v2.1.exr", "u2_v1.1.exr",
+                               "u2_v2.1.exr", "u1_v1.2.exr", "u1_v2.2.exr",
+                               "u2_v1.2.exr", "u2_v2.2.exr"})
+    folder.touch(filename);
+  folder.age();
+  const std::string filename = folder.path + ".cache";
+  Configuration configuration;
+  configuration.detectGrids = true;
+  const Items expected = {createGrid("u#_v#.#.exr", {{1, 2}, {1, 2}, {1, 2}})};
+  {
+    ScanCache cache(configuration);
+    EXPECT_EQ(cache.parseDir(folder.path).files, expected);
+    ASSERT_TRUE(cache.save(filename));
+  }
+  ScanCache cache(configuration);
+  ASSERT_TRUE(cache.load(filename));
+  EXPECT_EQ(cache.parseDir(folder.path).files, expected);
+  EXPECT_EQ(cache.hits, 1);
+  std::remove(filename.c_str());
+}
+
+TEST(ScanCache, corrupted) {
+  TemporaryFolder folder;
+  folder.touch("file1.jpg");
+  folder.touch("file2.jpg");
+  folder.touch("readme");
+  folder.age();
+  Configuration configuration;
+  {
+    ScanCache cache(configuration);
+    cache.parseDir(folder.path);
+    ASSERT_TRUE(cache.save(folder.get("cache")));
+  }
+  std::ifstream file(folder.get("cache"), std::ios::binary);
+  const std::string data((std::istreambuf_iterator<char>(file)),
+                         std::istreambuf_iterator<char>());
+  ScanCache cache(configuration);
+  // Truncated files and huge sizes are rejected without allocating them.
+  for (size_t size = 0; size < data.size(); ++size) {
+    folder.write("cache", data.substr(0, size));
+    EXPECT_FALSE(cache.load(folder.get("cache")));
+  }
+  for (size_t i = 0; i + 4 <= data.size(); ++i) {
+    std::string corrupted = data;
+    corrupted.replace(i, 4, 4, char(0xFF));
+    folder.write("cache", corrupted);
+    EXPECT_NO_THROW(cache.load(folder.get("cache")));
+  }
+}
+
+} // namespace sequence
@@ -0,0 +1,122 @@
+#include "sequence/Checksum.hpp"
+
+#include <cstring>
+#include <string>
+
+#if defined(__linux) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include <sequence/Tools.hpp>
+
+#include "TemporaryFolder.hpp"
+
+namespace sequence {
+
+#if defined(__linux) || defined(__APPLE__)
+
+TEST(Checksum, frames) {
+  TemporaryFolder folder;
+  folder.write("f1.exr", "one");
+  folder.write("f2.exr", "two");
+  folder.write("f3.exr", "one");
+  folder.write("g.exr", "one");
+  const Items items = {createSequence("f#.exr", 1, 3),
+                       createSingleFile("g.exr")};
+  const auto digests = checksumItems(folder.path, items);
+  ASSERT_EQ(2U, digests.size());
+  const auto &frames = digests[0].frames;
+  ASSERT_EQ(3U, frames.size());
+  EXPECT_EQ(0U, digests[0].failed);
+  EXPECT_EQ(1U, frames[0].frame);
+  EXPECT_EQ(3U, frames[2].frame);
+  EXPECT_TRUE(frames[0].read);
+  EXPECT_EQ(frames[0].digest, frames[2].digest); // same content
+  EXPECT_NE(frames[0].digest, frames[1].digest);
+  EXPECT_EQ(frames[0].digest, digests[1].frames[0].digest);
+  EXPECT_EQ(32U, frames[0].digest.toString().size());
+  // Same content under other frames gives another sequence digest.
+  const auto shifted =
+      checksumItems(folder.path, {createSequence("f#.exr", 2, 3)});
+  EXPECT_EQ(frames[1].digest, shifted[0].frames[0].digest);
+  EXPECT_NE(digests[0].digest, shifted[0].digest);
+}
+
+TEST(Checksum, independentOfOptions) {
+  TemporaryFolder folder;
+  std::string content;
+  for (size_t i = 0; i < (3 << 20) + 17; ++i)
+    content += char(i * 7 + i / 4096);
+  for (const char *filename : {"f1.exr", "f2.exr", "f3.exr", "f4.exr"})
+    folder.write(filename, content);
+  const Items items = {createSequence("f#.exr", 1, 4)};
+  ChecksumOptions options;
+  options.readers = 1;
+  options.blockSize = 1;
+  const auto small = checksumItems(folder.path, items, options);
+  options.readers = 3;
+  options.blockSize = 64 << 20;
+  const auto large = checksumItems(folder.path, items, options);
+  EXPECT_EQ(small[0].digest, large[0].digest);
+  EXPECT_EQ(small[0].frames[0].digest, large[0].frames[3].digest);
+  folder.write("f2.exr", content.substr(0, content.size() - 1));
+  const auto truncated = checksumItems(folder.path, items, options);
+  EXPECT_NE(large[0].frames[1].digest, truncated[0].frames[1].digest);
+  EXPECT_NE(large[0].digest, truncated[0].digest);
+}
+
+TEST(Checksum, missingFiles) {
+  TemporaryFolder folder;
+  folder.write("f1.exr", "one");
+  const auto digests =
+      checksumItems(folder.path, {createSequence("f#.exr", {1, 5})});
+  ASSERT_EQ(1U, digests.size());
+  EXPECT_EQ(1U, digests[0].failed);
+  EXPECT_TRUE(digests[0].frames[0].read);
+  EXPECT_FALSE(digests[0].frames[1].read);
+  EXPECT_EQ(5U, digests[0].frames[1].frame);
+  EXPECT_TRUE(checksumItems(folder.path + "/missing", {}).empty());
+  const Items items = {createSingleFile("f1.exr")};
+  EXPECT_TRUE(checksumItems(folder.get("f1.exr"), items).empty());
+  // A socket mode shares bits with S_IFDIR.
+  const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  ASSERT_GE(fd, 0);
+  sockaddr_un address = sockaddr_un();
+  address.sun_family = AF_UNIX;
+  const std::string path = folder.get("socket");
+  strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+  ASSERT_EQ(0, bind(fd, (const sockaddr *)&address, sizeof(address)));
+  EXPECT_TRUE(checksumItems(path, items).empty());
+  close(fd);
+}
+
+TEST(Checksum, indicedBatches) {
+  // Frames of an INDICED Item span several batches.
+  TemporaryFolder folder;
+  Indices indices;
+  for (Index frame = 3; frame < 60; frame += 3) {
+    indices.push_back(frame);
+    folder.write("f" + std::to_string(frame) + ".exr",
+                 frame % 2 ? "odd" : "even");
+  }
+  const auto digests =
+      checksumItems(folder.path, {createSequence("f#.exr", indices)});
+  ASSERT_EQ(1U, digests.size());
+  const auto &frames = digests[0].frames;
+  ASSERT_EQ(indices.size(), frames.size());
+  EXPECT_EQ(0U, digests[0].failed);
+  for (size_t i = 0; i < frames.size(); ++i) {
+    EXPECT_EQ(indices[i], frames[i].frame);
+    EXPECT_TRUE(frames[i].read);
+    EXPECT_EQ(frames[i % 2].digest, frames[i].digest);
+  }
+  EXPECT_NE(frames[0].digest, frames[1].digest);
+}
+
+#endif
+
+} // namespace sequence
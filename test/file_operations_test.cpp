@@ -0,0 +1,134 @@
+#include "sequence/FileOperations.hpp"
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <sequence/Tools.hpp>
+
+#include "TemporaryFolder.hpp"
+
+namespace sequence {
+
+namespace {
+
+FileOperation rename(const char *source, const char *target) {
+  return {FileOperation::RENAME, source, target};
+}
+
+FileOperation symlink(const char *source, const char *target) {
+  return {FileOperation::SYMLINK, source, target};
+}
+
+} // namespace
+
+TEST(FileOperations, planRenumber) {
+  const Plan plan = planRenumber("shot", createSequence("f#", 1, 4), 2);
+  EXPECT_EQ("shot", plan.folder);
+  ASSERT_EQ(2U, plan.chains.size());
+  EXPECT_EQ(FileOperations({rename("f3", "f5"), rename("f1", "f3")}),
+            plan.chains[0]);
+  EXPECT_EQ(FileOperations({rename("f4", "f6"), rename("f2", "f4")}),
+            plan.chains[1]);
+}
+
+TEST(FileOperations, planRenumberBackward) {
+  const Plan plan = planRenumber("shot", createSequence("f#", {3, 4, 5}), -1);
+  ASSERT_EQ(1U, plan.chains.size());
+  EXPECT_EQ(FileOperations({rename("f3", "f2"), rename("f4", "f3"),
+                            rename("f5", "f4")}),
+            plan.chains[0]);
+}
+
+TEST(FileOperations, planRenumberPattern) {
+  const Plan plan =
+      planRenumber("shot", createSequence("f#", 9, 10), 0, "f###");
+  ASSERT_EQ(2U, plan.chains.size());
+  EXPECT_EQ(FileOperations({rename("f9", "f009")}), plan.chains[0]);
+  EXPECT_EQ(FileOperations({rename("f10", "f010")}), plan.chains[1]);
+  EXPECT_TRUE(planRenumber("shot", createSequence("f#", 9, 10), 0)
+                  .chains.empty());
+}
+
+TEST(FileOperations, planRenumberInvalid) {
+  EXPECT_THROW(planRenumber("shot", createSequence("f#", 1, 4), -2),
+               std::invalid_argument);
+  EXPECT_THROW(planRenumber("shot", createSingleFile("f"), 1),
+               std::invalid_argument);
+  // The pattern must have one padding per location.
+  EXPECT_THROW(planRenumber("shot", createSequence("f#", 1, 4), 0, "f"),
+               std::invalid_argument);
+  EXPECT_THROW(planRenumber("shot", createSequence("f#", 1, 4), 0, "f#_#"),
+               std::invalid_argument);
+  const Item grid = createGrid("u#_v#.#", {{1, 2}, {1, 2}, {1, 3}});
+  EXPECT_THROW(planRenumber("shot", grid, 1, "u#.##"), std::invalid_argument);
+  EXPECT_THROW(planRelink("view", "..", grid, "g.#"), std::invalid_argument);
+  EXPECT_NO_THROW(planRelink("view", "..", grid, "g_#_#.#"));
+}
+
+TEST(FileOperations, planRelink) {
+  const Plan plan = planRelink("view", "../render",
+                               createSequence("beauty.#.exr", 1, 2),
+                               "b.####.exr", 100);
+  EXPECT_EQ(
+      std::vector<FileOperations>(
+          {{symlink("../render/beauty.1.exr", "b.0101.exr")},
+           {symlink("../render/beauty.2.exr", "b.0102.exr")}}),
+      plan.chains);
+  EXPECT_EQ("ln -s '../render/beauty.1.exr' 'view/b.0101.exr'\n"
+            "ln -s '../render/beauty.2.exr' 'view/b.0102.exr'\n",
+            formatPlan(plan));
+}
+
+TEST(FileOperations, formatPlan) {
+  Plan plan;
+  plan.folder = "it's";
+  plan.chains = {{rename("f2", "f3"), rename("f1", "f2")}};
+  EXPECT_EQ("mv -n 'it'\\''s/f2' 'it'\\''s/f3'\n"
+            "mv -n 'it'\\''s/f1' 'it'\\''s/f2'\n",
+            formatPlan(plan));
+}
+
+#if defined(__linux) || defined(__APPLE__)
+
+TEST(FileOperations, executeRenumber) {
+  TemporaryFolder folder;
+  for (int frame = 1; frame <= 50; ++frame)
+    folder.write("f" + std::to_string(frame), std::to_string(frame));
+  const Plan plan = planRenumber(folder.path, createSequence("f#", 1, 50), 7);
+  EXPECT_TRUE(executePlan(plan));
+  for (int frame = 1; frame <= 57; ++frame)
+    EXPECT_EQ(frame <= 7 ? "missing" : std::to_string(frame - 7),
+              folder.read("f" + std::to_string(frame)));
+}
+
+TEST(FileOperations, executeNoReplace) {
+  TemporaryFolder folder;
+  folder.write("f1", "1");
+  folder.write("f2", "2");
+  folder.write("f3", "keep");
+  Plan plan;
+  plan.folder = folder.path;
+  plan.chains = {{rename("f2", "f3"), rename("f1", "f2")}};
+  FileOperations failed;
+  EXPECT_FALSE(executePlan(plan, &failed));
+  EXPECT_EQ(plan.chains[0], failed);
+  EXPECT_EQ("keep", folder.read("f3"));
+  EXPECT_EQ("1", folder.read("f1"));
+}
+
+TEST(FileOperations, executeRelink) {
+  TemporaryFolder folder;
+  folder.write("f1", "1");
+  folder.write("f2", "2");
+  const Plan plan =
+      planRelink(folder.path, ".", createSequence("f#", 1, 2), "g##");
+  EXPECT_TRUE(executePlan(plan, nullptr, 1));
+  EXPECT_EQ("1", folder.read("g01"));
+  EXPECT_EQ("2", folder.read("g02"));
+  EXPECT_FALSE(executePlan(plan)); // links already exist
+}
+
+#endif
+
+} // namespace sequence
@@ -0,0 +1,105 @@
+#include "sequence/Filenames.hpp"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <sequence/Tools.hpp>
+
+namespace sequence {
+
+namespace {
+
+std::vector<std::string> expand(const Item &item) {
+  std::vector<std::string> filenames;
+  for (CStringView filename : getFilenames(item))
+    filenames.push_back(filename.toString());
+  return filenames;
+}
+
+typedef std::vector<std::string> Strings;
+
+} // namespace
+
+TEST(Filenames, single) {
+  EXPECT_EQ(Strings({"file.exr"}), expand(createSingleFile("file.exr")));
+  EXPECT_EQ(Strings(), expand(Item()));
+}
+
+TEST(Filenames, packed) {
+  EXPECT_EQ(Strings({"f098.exr", "f099.exr", "f100.exr"}),
+            expand(createSequence("f###.exr", 98, 100)));
+  EXPECT_EQ(Strings({"f9.exr", "f10.exr", "f11.exr"}),
+            expand(createSequence("f#.exr", 9, 11)));
+  EXPECT_EQ(Strings({"f99.exr", "f100.exr"}),
+            expand(createSequence("f##.exr", 99, 100)));
+  EXPECT_EQ(Strings({"f1.exr", "f4.exr", "f7.exr"}),
+            expand(createSequence("f#.exr", 1, 8, 3)));
+  EXPECT_EQ(Strings({"f0.exr"}), expand(createSequence("f#.exr", 0, 0)));
+}
+
+TEST(Filenames, indiced) {
+  EXPECT_EQ(Strings({"shot_0001.exr", "shot_0002.exr", "shot_1000.exr",
+                     "shot_12345.exr"}),
+            expand(createSequence("shot_####.exr", {1, 2, 1000, 12345})));
+}
+
+TEST(Filenames, frames) {
+  const Item item = createSequence("f#.exr", 5, 6);
+  auto itr = FilenameIterator(item);
+  EXPECT_EQ(5U, itr.frame());
+  EXPECT_EQ("f5.exr", (*itr++).toString());
+  EXPECT_EQ(6U, itr.frame());
+  EXPECT_NE(FilenameIterator(), itr);
+  EXPECT_EQ(FilenameIterator(), ++itr);
+}
+
+TEST(Filenames, grid) {
+  const Item item = createGrid("u#_v#.##.exr", {{1, 2}, {8, 10}, {99, 100}});
+  EXPECT_EQ(12U, countFilenames(item));
+  const Strings filenames = expand(item);
+  ASSERT_EQ(12U, filenames.size());
+  EXPECT_EQ("u1_v8.99.exr", filenames[0]);
+  EXPECT_EQ("u1_v8.100.exr", filenames[1]);
+  EXPECT_EQ("u1_v9.99.exr", filenames[2]);
+  EXPECT_EQ("u1_v10.100.exr", filenames[5]);
+  EXPECT_EQ("u2_v8.99.exr", filenames[6]);
+  EXPECT_EQ("u2_v10.100.exr", filenames[11]);
+  auto itr = FilenameIterator(item);
+  EXPECT_EQ(99U, itr.frame());
+  EXPECT_EQ(Indices({1, 8, 99}), itr.locations());
+}
+
+TEST(Filenames, batches) {
+  const Item packed = createSequence("f#.exr", 1, 100, 3);
+  EXPECT_EQ(34U, countFilenames(packed));
+  auto itr = FilenameIterator(packed, 10, 3);
+  EXPECT_EQ("f31.exr", (*itr++).toString());
+  EXPECT_EQ("f34.exr", (*itr++).toString());
+  EXPECT_EQ("f37.exr", (*itr++).toString());
+  EXPECT_EQ(FilenameIterator(), itr);
+  EXPECT_EQ(FilenameIterator(), FilenameIterator(packed, 34, 1));
+  const Item indiced = createSequence("f#.exr", {1, 5, 7, 9});
+  EXPECT_EQ(4U, countFilenames(indiced));
+  itr = FilenameIterator(indiced, 3, 10);
+  EXPECT_EQ("f9.exr", (*itr++).toString());
+  EXPECT_EQ(FilenameIterator(), itr);
+  const Item grid = createGrid("u#_##", {{1, 3}, {10, 12}});
+  itr = FilenameIterator(grid, 5, 2);
+  EXPECT_EQ("u2_12", (*itr++).toString());
+  EXPECT_EQ("u3_10", (*itr++).toString());
+  EXPECT_EQ(FilenameIterator(), itr);
+  EXPECT_EQ(1U, countFilenames(createSingleFile("f.exr")));
+  EXPECT_EQ(0U, countFilenames(Item()));
+}
+
+TEST(Filenames, invalidPattern) {
+  EXPECT_THROW(FilenameIterator(createSequence("f#_#.exr", {1, 2})),
+               std::invalid_argument);
+  Item grid = createGrid("f#_#.exr", {{1, 2}, {1, 2}});
+  grid.filename = "f#.exr";
+  EXPECT_THROW(getFilenames(grid).begin(), std::invalid_argument);
+}
+
+} // namespace sequence
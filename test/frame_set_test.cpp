@@ -0,0 +1,154 @@
+#include "sequence/FrameSet.hpp"
+
+#include <cstdlib>
+#include <set>
+
+#include <gtest/gtest.h>
+
+namespace sequence {
+
+TEST(FrameSet, getFrameSet) {
+  EXPECT_EQ(FrameRanges({{1, 10}}),
+            getFrameSet(createSequence("f#.exr", 1, 10)));
+  EXPECT_EQ(FrameRanges({{1, 7, 3}}),
+            getFrameSet(createSequence("f#.exr", 1, 8, 3)));
+  EXPECT_EQ(FrameRanges({{1, 3}, {5, 5}, {7, 8}}),
+            getFrameSet(createSequence("f#.exr", {1, 2, 3, 5, 7, 8})));
+  EXPECT_EQ(FrameRanges({{1, 3}}),
+            getFrameSet(createSequence("f#.exr", {3, 1, 2, 2})));
+  EXPECT_EQ(FrameRanges(), getFrameSet(createSingleFile("f.exr")));
+}
+
+TEST(FrameSet, operations) {
+  const FrameRanges a = {{1, 10}, {20, 30}};
+  const FrameRanges b = {{5, 22}, {30, 40}};
+  EXPECT_EQ(FrameRanges({{1, 40}}), unite(a, b));
+  EXPECT_EQ(FrameRanges({{1, 10}, {20, 30}}), unite(a, FrameRanges()));
+  EXPECT_EQ(FrameRanges({{1, 12}}),
+            unite(FrameRanges{{1, 5}}, FrameRanges{{6, 12}}));
+  EXPECT_EQ(FrameRanges({{5, 10}, {20, 22}, {30, 30}}), intersect(a, b));
+  EXPECT_EQ(FrameRanges({{1, 4}, {23, 29}}), subtract(a, b));
+  EXPECT_EQ(FrameRanges({{11, 19}, {31, 40}}), subtract(b, a));
+  EXPECT_EQ(FrameRanges({{11, 19}}), getGaps(a));
+  EXPECT_EQ(FrameRanges(), getGaps(FrameRanges({{1, 2}})));
+  EXPECT_EQ(21U, countFrames(a));
+  EXPECT_EQ(4294967296U, countFrames({{0, 4294967295}}));
+  const FrameRanges all = {{0, 4294967295}};
+  EXPECT_EQ(FrameRanges(), subtract(all, all));
+}
+
+TEST(FrameSet, items) {
+  const Item expected = createSequence("beauty.####.exr", 1, 1000);
+  const Item present =
+      createSequence("beauty.####.exr", {1, 2, 3, 5, 6, 7, 1000});
+  EXPECT_EQ(FrameRanges({{4, 4}, {8, 999}}), subtract(expected, present));
+  EXPECT_EQ(FrameRanges({{4, 4}, {8, 999}}), getGaps(present));
+  EXPECT_EQ(FrameRanges({{1, 1000}}), unite(expected, present));
+  EXPECT_EQ(getFrameSet(present), intersect(expected, present));
+  EXPECT_THROW(unite(expected, createSequence("depth.####.exr", 1, 10)),
+               std::invalid_argument);
+  EXPECT_EQ(Items({createSequence("beauty.####.exr", 4, 4),
+                   createSequence("beauty.####.exr", 8, 999)}),
+            toItems("beauty.####.exr", getGaps(present)));
+}
+
+TEST(FrameSet, steps) {
+  const FrameRanges odd = {{1, 99, 2}}, even = {{2, 100, 2}};
+  EXPECT_EQ(FrameRanges({{1, 100}}), unite(odd, even));
+  EXPECT_EQ(FrameRanges(), intersect(odd, even));
+  EXPECT_EQ(odd, subtract(odd, even));
+  EXPECT_EQ(even, subtract(FrameRanges({{1, 100}}), odd));
+  EXPECT_EQ(FrameRanges({{3, 99, 6}}), intersect(odd, {{0, 99, 3}}));
+  EXPECT_EQ(even, getGaps(FrameRanges({{1, 101, 2}})));
+  EXPECT_EQ(FrameRanges({{2, 3}, {5, 6}}), getGaps({{1, 7, 3}}));
+  EXPECT_EQ(50U, countFrames(odd));
+  // Progressions are kept whole around contiguous frames.
+  EXPECT_EQ(FrameRanges({{1, 9, 2}, {10, 20}, {21, 99, 2}}),
+            unite(odd, {{10, 20}}));
+  EXPECT_EQ(Items({createSequence("f#", 1, 99, 2)}), toItems("f#", odd));
+  // Steps an Item cannot hold give INDICED Items.
+  const Items large = toItems("f#.exr", {{0, 400, 200}});
+  EXPECT_EQ(Items({createSequence("f#.exr", {0, 200, 400})}), large);
+  EXPECT_TRUE(subtract({{0, 400, 200}}, getFrameSet(large[0])).empty());
+  EXPECT_EQ(3U, countFrames(getFrameSet(large[0])));
+  EXPECT_EQ(Items({createSequence("f#.exr", 0, 254, 127)}),
+            toItems("f#.exr", {{0, 254, 127}}));
+}
+
+TEST(FrameSet, itemsSharingPattern) {
+  const Items items = {createSequence("beauty.####.exr", 1, 500),
+                       createSequence("depth.####.exr", 1, 1000),
+                       createSequence("beauty.####.exr", 502, 1000)};
+  EXPECT_EQ(FrameRanges({{1, 500}, {502, 1000}}),
+            getFrameSet(items, "beauty.####.exr"));
+  EXPECT_EQ(FrameRanges({{501, 501}}),
+            subtract(getFrameSet(items, "depth.####.exr"),
+                     getFrameSet(items, "beauty.####.exr")));
+}
+
+// Compares stepped ranges with std::set based operations.
+TEST(FrameSet, stepsSameAsSets) {
+  std::srand(1);
+  const auto randomRanges = [] {
+    FrameRanges ranges;
+    for (Index start = std::rand() % 10; start < 300;) {
+      const Index step = 1 + std::rand() % 4;
+      const Index end = start + step * (std::rand() % 10);
+      ranges.emplace_back(start, end, start == end ? 1 : step);
+      start = end + 1 + std::rand() % 10;
+    }
+    return ranges;
+  };
+  const auto toSet = [](const FrameRanges &ranges) {
+    std::set<Index> frames;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      const FrameRange &range = ranges[i];
+      EXPECT_EQ(0U, (range.end - range.start) % range.step);
+      if (i > 0) {
+        EXPECT_LT(ranges[i - 1].end, range.start);
+      }
+      for (Index frame = range.start; frame <= range.end; frame += range.step)
+        frames.insert(frame);
+    }
+    return frames;
+  };
+  for (int test = 0; test < 100; ++test) {
+    const FrameRanges a = randomRanges(), b = randomRanges();
+    const std::set<Index> setA = toSet(a), setB = toSet(b);
+    std::set<Index> united = setA, intersection, difference;
+    united.insert(setB.begin(), setB.end());
+    for (const Index frame : setA)
+      (setB.count(frame) ? intersection : difference).insert(frame);
+    EXPECT_EQ(united, toSet(unite(a, b)));
+    EXPECT_EQ(intersection, toSet(intersect(a, b)));
+    EXPECT_EQ(difference, toSet(subtract(a, b)));
+    EXPECT_EQ(setA.size(), countFrames(a));
+  }
+}
+
+// Compares with std::set based operations.
+TEST(FrameSet, sameAsSets) {
+  std::srand(0);
+  const auto randomFrames = [] {
+    std::set<Index> frames;
+    for (int i = 0; i < 100; ++i)
+      frames.insert(std::rand() % 200);
+    return frames;
+  };
+  const auto toRanges = [](const std::set<Index> &frames) {
+    return getFrameSet(
+        createSequence("f#", Indices(frames.begin(), frames.end())));
+  };
+  for (int test = 0; test < 100; ++test) {
+    const std::set<Index> a = randomFrames(), b = randomFrames();
+    std::set<Index> united = a, intersection, difference;
+    united.insert(b.begin(), b.end());
+    for (const Index frame : a)
+      (b.count(frame) ? intersection : difference).insert(frame);
+    EXPECT_EQ(toRanges(united), unite(toRanges(a), toRanges(b)));
+    EXPECT_EQ(toRanges(intersection), intersect(toRanges(a), toRanges(b)));
+    EXPECT_EQ(toRanges(difference), subtract(toRanges(a), toRanges(b)));
+  }
+}
+
+} // namespace sequence
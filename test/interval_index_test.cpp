@@ -0,0 +1,72 @@
+#include "sequence/IntervalIndex.hpp"
+
+#include <cstdlib>
+
+#include <gtest/gtest.h>
+
+#include <sequence/FrameSet.hpp>
+#include <sequence/Tools.hpp>
+
+namespace sequence {
+
+typedef std::vector<size_t> Found;
+
+TEST(IntervalIndex, overlap) {
+  const Items items = {createSequence("a#.exr", 1, 100),
+                       createSingleFile("b.exr"),
+                       createSequence("c#.exr", {1, 2, 3, 50, 51, 200}),
+                       createSequence("d#.exr", 10, 40, 10),
+                       createSequence("e#.exr", 150, 300)};
+  const IntervalIndex index(items);
+  EXPECT_EQ(6U, index.size());
+  Found found;
+  index.overlap(1001, 1050, found);
+  EXPECT_EQ(Found(), found);
+  index.overlap(45, 55, found);
+  EXPECT_EQ(Found({0, 2}), found);
+  index.overlap(1, 300, found);
+  EXPECT_EQ(Found({0, 2, 3, 4}), found);
+  index.overlap(21, 29, found); // d has frames 10, 20, 30 and 40
+  EXPECT_EQ(Found({0}), found);
+  index.overlap(25, 30, found);
+  EXPECT_EQ(Found({0, 3}), found);
+  index.stab(200, found);
+  EXPECT_EQ(Found({2, 4}), found);
+  index.stab(4, found);
+  EXPECT_EQ(Found({0}), found);
+  index.overlap(10, 5, found);
+  EXPECT_EQ(Found(), found);
+}
+
+// Compares with a linear scan.
+TEST(IntervalIndex, sameAsLinearScan) {
+  std::srand(0);
+  Items items;
+  for (int i = 0; i < 200; ++i) {
+    const Index start = std::rand() % 1000;
+    if (i % 2) {
+      items.push_back(createSequence("f#", start, start + std::rand() % 100,
+                                     1 + std::rand() % 3));
+    } else {
+      Indices indices;
+      for (Index frame = start; frame < start + 100;
+           frame += 1 + std::rand() % 10)
+        indices.push_back(frame);
+      items.push_back(createSequence("f#", std::move(indices)));
+    }
+  }
+  const IntervalIndex index(items);
+  Found found;
+  for (int test = 0; test < 200; ++test) {
+    const Index start = std::rand() % 1100;
+    const Index end = start + std::rand() % 50;
+    Found expected;
+    for (size_t i = 0; i < items.size(); ++i)
+      if (!intersect(getFrameSet(items[i]), {{start, end}}).empty())
+        expected.push_back(i);
+    index.overlap(start, end, found);
+    EXPECT_EQ(expected, found) << start << "-" << end;
+  }
+}
+
+} // namespace sequence
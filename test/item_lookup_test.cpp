@@ -0,0 +1,74 @@
+#include "sequence/ItemLookup.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sequence/Tools.hpp>
+
+namespace sequence {
+
+TEST(ItemLookup, find) {
+  const Items items = {createSingleFile("beauty.exr"),
+                       createSequence("beauty.#####.exr", {1, 2, 1042}),
+                       createSequence("shot01_depth.#.exr", 1, 9, 2),
+                       createSequence("shot01_depth.####.exr", {10, 20})};
+  const ItemLookup lookup(items);
+  EXPECT_EQ(&items[0], lookup.find("beauty.exr"));
+  EXPECT_EQ(&items[1], lookup.find("beauty.01042.exr"));
+  EXPECT_EQ(nullptr, lookup.find("beauty.01043.exr"));
+  EXPECT_EQ(nullptr, lookup.find("beauty.1042.exr"));  // padding too small
+  EXPECT_EQ(nullptr, lookup.find("beauty.001042.exr")); // padding too large
+  EXPECT_EQ(&items[2], lookup.find("shot01_depth.7.exr"));
+  EXPECT_EQ(nullptr, lookup.find("shot01_depth.8.exr"));
+  EXPECT_EQ(nullptr, lookup.find("shot01_depth.07.exr"));
+  EXPECT_EQ(&items[3], lookup.find("shot01_depth.0020.exr"));
+  EXPECT_EQ(nullptr, lookup.find("shot02_depth.0020.exr"));
+  EXPECT_EQ(nullptr, lookup.find("beauty.99999999999.exr"));
+}
+
+TEST(ItemLookup, findSequence) {
+  const Items items = {createSequence("f#.exr", 1, 10, 1),
+                       createSequence("f#.exr", 20, 30, 1)};
+  const ItemLookup lookup(items);
+  Index frame = 0;
+  EXPECT_EQ(&items[1], lookup.findSequence("f25.exr", frame));
+  EXPECT_EQ(25U, frame);
+  EXPECT_EQ(&items[0], lookup.findSequence("f15.exr", frame));
+  EXPECT_EQ(15U, frame);
+  EXPECT_EQ(nullptr, lookup.findSequence("g15.exr", frame));
+}
+
+TEST(ItemLookup, manyHoles) {
+  // A packed sequence with a hole every other frame, items out of order.
+  Items items;
+  for (Index start = 20000; start > 0; start -= 2)
+    items.push_back(createSequence("f####.exr", start, start));
+  items.push_back(createSequence("f#.exr", {1, 3, 5}));
+  items.push_back(createSequence("f####.exr", {3, 5}));
+  const ItemLookup lookup(items);
+  EXPECT_EQ(&items[0], lookup.find("f20000.exr"));
+  EXPECT_EQ(&items[9999], lookup.find("f0002.exr"));
+  EXPECT_EQ(&items[5000], lookup.find("f10000.exr"));
+  EXPECT_EQ(nullptr, lookup.find("f10001.exr"));
+  EXPECT_EQ(&items[10000], lookup.find("f3.exr"));
+  EXPECT_EQ(&items[10001], lookup.find("f0003.exr"));
+  Index frame = 0;
+  EXPECT_EQ(&items[5000], lookup.findSequence("f10001.exr", frame));
+  EXPECT_EQ(10001U, frame);
+  EXPECT_EQ(&items[9999], lookup.findSequence("f0001.exr", frame));
+}
+
+TEST(ItemLookup, unsortedIndices) {
+  EXPECT_THROW(ItemLookup({createSequence("f#.exr", {2, 1})}),
+               std::invalid_argument);
+}
+
+TEST(ItemLookup, contains) {
+  EXPECT_TRUE(contains(createSequence("f#.exr", 1, 9, 2), 5));
+  EXPECT_FALSE(contains(createSequence("f#.exr", 1, 9, 2), 4));
+  EXPECT_FALSE(contains(createSequence("f#.exr", 1, 9, 2), 11));
+  EXPECT_TRUE(contains(createSequence("f#.exr", {1, 4}), 4));
+  EXPECT_FALSE(contains(createSequence("f#.exr", {1, 4}), 3));
+  EXPECT_FALSE(contains(createSingleFile("f1.exr"), 1));
+}
+
+} // namespace sequence
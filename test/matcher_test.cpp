@@ -0,0 +1,121 @@
+#include "sequence/Matcher.hpp"
+
+#include <cstdlib>
+#include <regex>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <sequence/Tools.hpp>
+
+namespace sequence {
+
+TEST(Matcher, invalid) {
+  EXPECT_THROW(Matcher(""), std::invalid_argument);
+  EXPECT_THROW(Matcher("missing_padding_character"), std::invalid_argument);
+}
+
+TEST(Matcher, padding) {
+  const Matcher any("file-@.png");
+  EXPECT_TRUE(any("file-#.png"));
+  EXPECT_TRUE(any("file-####.png"));
+  EXPECT_FALSE(any("file-.png"));
+  EXPECT_FALSE(any("file-1.png"));
+  const Matcher exact("file-##.png");
+  EXPECT_TRUE(exact("file-##.png"));
+  EXPECT_FALSE(exact("file-#.png"));
+  EXPECT_FALSE(exact("file-###.png"));
+}
+
+TEST(Matcher, literals) {
+  const Matcher matcher("file.#(1)+");
+  EXPECT_TRUE(matcher("file.#(1)+"));
+  EXPECT_FALSE(matcher("fileX#(1)+"));
+  EXPECT_FALSE(matcher("file.#(1)"));
+  EXPECT_FALSE(matcher("file.#(1)++"));
+}
+
+TEST(Matcher, stars) {
+  const Matcher matcher("*.#.*");
+  EXPECT_TRUE(matcher(".#."));
+  EXPECT_TRUE(matcher("a.b.###.exr"));
+  EXPECT_FALSE(matcher("a.b.###"));
+  EXPECT_TRUE(Matcher("*#*")("#"));
+  EXPECT_FALSE(Matcher("a*a#")("a#"));
+  EXPECT_TRUE(Matcher("a*a#")("aa#"));
+  EXPECT_FALSE(Matcher("ab*ba#")("aba#"));
+  EXPECT_TRUE(Matcher("*a*b*c*#")("xxaxbxxcb#"));
+  EXPECT_FALSE(Matcher("*a*b*c*#")("xxcxbxxa#"));
+  EXPECT_TRUE(Matcher("**#**")("x#x"));
+}
+
+TEST(Matcher, ignoreCase) {
+  EXPECT_FALSE(Matcher("FILE-#.Png")("file-#.png"));
+  EXPECT_TRUE(Matcher("FILE-#.Png", true)("file-#.pNG"));
+  EXPECT_TRUE(Matcher("*.EXR#", true)("a.exr#"));
+}
+
+// Compares with the regular expression generated by getMatcherString.
+TEST(Matcher, sameAsRegex) {
+  const char alphabet[] = "ab#.*";
+  std::srand(0);
+  const auto randomString = [](const char *characters, size_t count) {
+    std::string output;
+    const size_t size = std::rand() % 7;
+    for (size_t i = 0; i < size; ++i)
+      output += characters[std::rand() % count];
+    return output;
+  };
+  for (int test = 0; test < 2000; ++test) {
+    const std::string pattern = randomString(alphabet, 5) + "#";
+    const std::regex regex(details::getMatcherString(pattern));
+    const Matcher matcher(pattern);
+    for (int i = 0; i < 20; ++i) {
+      const std::string candidate = randomString(alphabet, 4) + "#" +
+                                    randomString(alphabet, 4);
+      EXPECT_EQ(std::regex_match(candidate, regex), matcher(candidate))
+          << pattern << " " << candidate;
+    }
+  }
+}
+
+constexpr auto kExrMatcher = compilePattern("*.####.exr");
+static_assert(kExrMatcher.firstStar == 0 && kExrMatcher.lastStar == 0,
+              "stars are found at compile time");
+static_assert(!kExrMatcher.anyPadding, "padding is counted at compile time");
+
+TEST(Matcher, compilePattern) {
+  EXPECT_TRUE(kExrMatcher("plate.####.exr"));
+  EXPECT_FALSE(kExrMatcher("plate.###.exr"));
+  EXPECT_FALSE(kExrMatcher("plate.####.EXR"));
+  constexpr auto ignoreCase = compilePattern("*.@.exr", true);
+  EXPECT_TRUE(ignoreCase("plate.#.EXR"));
+  EXPECT_TRUE(ignoreCase("plate.###.exr"));
+  EXPECT_FALSE(ignoreCase("plate..exr"));
+  EXPECT_TRUE(compilePattern("a*b*c@")("abc#"));
+  EXPECT_FALSE(compilePattern("a*b*c@")("acb#"));
+  // Invalid patterns fail to compile in constant expressions and throw
+  // otherwise.
+  EXPECT_THROW(compilePattern(""), std::invalid_argument);
+  EXPECT_THROW(compilePattern("no_padding"), std::invalid_argument);
+}
+
+// Compares with the runtime Matcher.
+TEST(Matcher, compilePatternSameAsMatcher) {
+  const char *candidates[] = {"#", "a#", "a.#.b", "ab##b", "a.###.b", "b#a"};
+  const auto check = [&candidates](const CompiledPattern &compiled,
+                                   const char *pattern) {
+    const Matcher matcher(pattern);
+    for (const char *candidate : candidates)
+      EXPECT_EQ(matcher(candidate), compiled(candidate))
+          << pattern << " " << candidate;
+  };
+  check(compilePattern("@"), "@");
+  check(compilePattern("*#"), "*#");
+  check(compilePattern("a*#*b"), "a*#*b");
+  check(compilePattern("*.@.*"), "*.@.*");
+  check(compilePattern("*b##b"), "*b##b");
+  check(compilePattern("a*.*#*.*b"), "a*.*#*.*b");
+}
+
+} // namespace sequence
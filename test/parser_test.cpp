@@ -1,5 +1,7 @@
 #include <sequence/Parser.hpp>
+#include <sequence/ParserStrategies.hpp>
 
+#include <algorithm>
 #include <utility>
 
 #include <gtest/gtest.h>
@@ -117,4 +119,179 @@ TEST(Parser, fileWithPattern) {
             content.files);
 }
 
+TEST(Parser, packedWhileIngesting) {
+  StringFileLister lister({"f3.jpg", "f4.jpg", "f1.jpg", "f2.jpg", "f7.jpg"});
+  Configuration configuration;
+  configuration.pack = true;
+  const auto content = parse(configuration, lister());
+  EXPECT_EQ(Items({createSequence("f#.jpg", 1, 4),
+                   createSequence("f#.jpg", 7, 7)}),
+            content.files);
+  // Without packing indices are all reported.
+  StringFileLister other({"f3.jpg", "f4.jpg", "f1.jpg", "f2.jpg", "f7.jpg"});
+  EXPECT_EQ(Items({createSequence("f#.jpg", {1, 2, 3, 4, 7})}),
+            parse(Configuration(), other()).files);
+}
+
+TEST(Parser, unionRoots) {
+  StringFileLister vol1({"beauty.0001.exr", "beauty.0002.exr", "readme"});
+  StringFileLister vol2({"beauty.0003.exr", "beauty.0004.exr", "readme"});
+  Configuration configuration;
+  configuration.pack = true;
+  const auto content = parse(configuration, {vol1(), vol2()});
+  EXPECT_EQ(Items({createSequence("beauty.####.exr", 1, 4),
+                   createSingleFile("readme")}),
+            content.files);
+  ASSERT_EQ(content.origins.size(), 2);
+  EXPECT_EQ(Origins({{0, 1, 2}, {1, 3, 4}}), content.origins[0]);
+  EXPECT_EQ(Origins({{0, Index(-1), Index(-1)}, {1, Index(-1), Index(-1)}}),
+            content.origins[1]);
+}
+
+TEST(Parser, unionRootsMergePadding) {
+  StringFileLister vol1({"f8.jpg", "f9.jpg"});
+  StringFileLister vol2({"f10.jpg", "f11.jpg", "g1.jpg"});
+  Configuration configuration;
+  configuration.pack = true;
+  configuration.mergePadding = true;
+  const auto content = parse(configuration, {vol1(), vol2()});
+  EXPECT_EQ(Items({createSequence("f#.jpg", 8, 11),
+                   createSingleFile("g1.jpg")}),
+            content.files);
+  ASSERT_EQ(content.origins.size(), 2);
+  EXPECT_EQ(Origins({{0, 8, 9}, {1, 10, 11}}), content.origins[0]);
+}
+
+TEST(Parser, unionRootsSingleFrame) {
+  // A root holding a single frame joins the sequence of the other roots, as
+  // if the roots were parsed together.
+  StringFileLister vol1({"beauty.0001.exr", "g1.jpg"});
+  StringFileLister vol2({"beauty.0002.exr", "beauty.0003.exr",
+                         "beauty.0004.exr", "g2.jpg", "h1.jpg"});
+  StringFileLister vol3({"g3.jpg", "h1.jpg"});
+  StringFileLister all({"beauty.0001.exr", "g1.jpg", "beauty.0002.exr",
+                        "beauty.0003.exr", "beauty.0004.exr", "g2.jpg",
+                        "h1.jpg", "g3.jpg"});
+  Configuration configuration;
+  configuration.pack = true;
+  configuration.sort = true;
+  const auto content = parse(configuration, {vol1(), vol2(), vol3()});
+  EXPECT_EQ(Items({createSequence("beauty.####.exr", 1, 4),
+                   createSequence("g#.jpg", 1, 3),
+                   createSingleFile("h1.jpg")}),
+            content.files);
+  EXPECT_EQ(parse(configuration, all()).files, content.files);
+  ASSERT_EQ(content.origins.size(), 3);
+  EXPECT_EQ(Origins({{0, 1, 1}, {1, 2, 4}}), content.origins[0]);
+  EXPECT_EQ(Origins({{0, 1, 1}, {1, 2, 2}, {2, 3, 3}}), content.origins[1]);
+  EXPECT_EQ(Origins({{1, Index(-1), Index(-1)}, {2, Index(-1), Index(-1)}}),
+            content.origins[2]);
+}
+
+TEST(Parser, detectGrids) {
+  StringFileLister lister({"u1_v1.1001.exr", "u1_v1.1002.exr",
+                           "u1_v2.1001.exr", "u1_v2.1002.exr",
+                           "u2_v1.1001.exr", "u2_v1.1002.exr",
+                           "u2_v2.1001.exr", "u2_v2.1002.exr",
+                           "u3_v1.1001.exr"});
+  Configuration configuration;
+  configuration.detectGrids = true;
+  const auto content = parse(configuration, lister());
+  // The lone u3 file breaks the grid.
+  EXPECT_EQ(3U, content.files.size());
+  StringFileLister complete({"u1_v1.1001.exr", "u1_v1.1002.exr",
+                             "u1_v2.1001.exr", "u1_v2.1002.exr",
+                             "u2_v1.1001.exr", "u2_v1.1002.exr",
+                             "u2_v2.1001.exr", "u2_v2.1002.exr"});
+  EXPECT_EQ(
+      Items({createGrid("u#_v#.####.exr", {{1, 2}, {1, 2}, {1001, 1002}})}),
+      parse(configuration, complete()).files);
+}
+
+namespace {
+
+// Keeps the location holding the largest values, counting its calls.
+struct RetainLargestValues {
+  size_t *calls;
+
+  size_t operator()(const details::Bucket &bucket) const {
+    ++*calls;
+    const auto &columns = bucket.columns;
+    size_t largest = 0;
+    for (size_t i = 1; i < columns.size(); ++i)
+      if (*std::max_element(columns[i].begin(), columns[i].end()) >
+          *std::max_element(columns[largest].begin(), columns[largest].end()))
+        largest = i;
+    return largest == 0 ? 1 : 0;
+  }
+};
+
+} // namespace
+
+TEST(Parser, customStrategy) {
+  // Versions have more distinct values than frames, RETAIN_HIGHEST_VARIANCE
+  // would keep them.
+  StringFileLister lister({"shot_v1.1001.exr", "shot_v1.1002.exr",
+                           "shot_v2.1001.exr", "shot_v3.1001.exr"});
+  size_t calls = 0;
+  const auto content =
+      parse(Configuration(), lister(), RetainLargestValues{&calls});
+  EXPECT_EQ(Items({createSequence("shot_v1.####.exr", {1001, 1002}),
+                   createSingleFile("shot_v2.1001.exr"),
+                   createSingleFile("shot_v3.1001.exr")}),
+            content.files);
+  EXPECT_EQ(calls, 1U);
+}
+
+TEST(Parser, predefinedStrategies) {
+  const std::initializer_list<std::string> files = {
+      "file-01-01.jpg", "file-01-02.jpg", "file-02-02.jpg", "file-03-02.jpg"};
+  Configuration configuration;
+  configuration.getPivotIndex = RETAIN_FIRST_LOCATION;
+  StringFileLister byEnum(files), byPolicy(files);
+  EXPECT_EQ(parse(configuration, byEnum()).files,
+            parse(Configuration(), byPolicy(), RetainFirstLocation()).files);
+}
+
+TEST(Parser, unionRootsDisjointRanges) {
+  StringFileLister vol1({"f1.jpg", "f2.jpg", "f8.jpg"});
+  StringFileLister vol2({"f2.jpg", "f3.jpg", "f9.jpg"});
+  Configuration configuration;
+  configuration.pack = true;
+  const auto content = parse(configuration, {vol1(), vol2()});
+  EXPECT_EQ(Items({createSequence("f#.jpg", 1, 3),
+                   createSequence("f#.jpg", 8, 9)}),
+            content.files);
+  ASSERT_EQ(content.origins.size(), 2);
+  EXPECT_EQ(Origins({{0, 1, 2}, {1, 3, 3}}), content.origins[0]);
+  EXPECT_EQ(Origins({{0, 8, 8}, {1, 9, 9}}), content.origins[1]);
+}
+
+TEST(Parser, filters) {
+  StringFileLister lister({"f1.exr", "f2.exr", "f3.exr.tmp", ".f4.exr",
+                           "f5.jpg", "f6.EXR"});
+  Configuration configuration;
+  configuration.includeSuffixes = {".exr", ".tmp"};
+  configuration.excludePrefixes = {"."};
+  configuration.excludeSuffixes = {".tmp"};
+  const auto content = parse(configuration, lister());
+  EXPECT_EQ(Items({createSequence("f#.exr", {1, 2})}), content.files);
+}
+
+TEST(Parser, acceptEntry) {
+  std::string hidden = ".git", tmp = "render.tmp", exr = "render.exr";
+  Configuration configuration;
+  EXPECT_TRUE(acceptEntry(configuration, {hidden, true}));
+  configuration.includeSuffixes = {".exr"};
+  configuration.excludePrefixes = {"."};
+  configuration.excludeSuffixes = {".tmp"};
+  // Includes only apply to files.
+  EXPECT_FALSE(acceptEntry(configuration, {tmp, false}));
+  EXPECT_TRUE(acceptEntry(configuration, {exr, false}));
+  EXPECT_TRUE(acceptEntry(configuration, {exr, true}));
+  // Excludes prune directories.
+  EXPECT_FALSE(acceptEntry(configuration, {hidden, true}));
+  EXPECT_FALSE(acceptEntry(configuration, {tmp, true}));
+}
+
 } // namespace sequence
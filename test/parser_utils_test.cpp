@@ -2,6 +2,7 @@
 
 #include <gtest/gtest.h>
 
+#include "sequence/Tools.hpp"
 #include "sequence/details/ParserUtils.hpp"
 
 namespace sequence {
@@ -76,6 +77,113 @@ TEST(splitAll, retainHighestVariance) {
   EXPECT_EQ(results[1].sortedIndices, Indices());
 }
 
+TEST(retainFewestItems, simple) {
+  EXPECT_EQ(retainFewestItems(getBucket()), 1);
+}
+
+TEST(splitAll, retainFewestItems) {
+  const auto results = splitAndSort(RETAIN_FEWEST_ITEMS);
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_EQ(results[0].pattern, "/path_101/file-##-02.jpg");
+  EXPECT_EQ(results[0].sortedIndices, Indices({1, 2, 3}));
+  EXPECT_EQ(results[1].pattern, "/path_101/file-01-01.jpg");
+}
+
+// Versions 1 and 2 of frames numbered twice.
+Bucket getCorrelatedBucket() {
+  Bucket bucket("img_v#.####_####.exr");
+  bucket.columns.resize(3);
+  for (Index version = 1; version <= 2; ++version) {
+    for (Index frame = 1; frame <= 50; ++frame) {
+      bucket.columns[0].push_back(version);
+      bucket.columns[1].push_back(frame);
+      bucket.columns[2].push_back(frame);
+    }
+  }
+  return bucket;
+}
+
+TEST(splitAll, retainFewestItemsCorrelated) {
+  const auto scattered =
+      splitAndSort(RETAIN_HIGHEST_VARIANCE, getCorrelatedBucket());
+  EXPECT_EQ(100U, scattered.size());
+  const auto results =
+      splitAndSort(RETAIN_FEWEST_ITEMS, getCorrelatedBucket());
+  ASSERT_EQ(results.size(), 50U);
+  EXPECT_EQ(results[0].pattern, "img_v#.0001_0001.exr");
+  EXPECT_EQ(results[0].sortedIndices, Indices({1, 2}));
+  EXPECT_EQ(results[49].pattern, "img_v#.0050_0050.exr");
+}
+
+// Every combination of u in [1, 3], v in [1, 2] and frames in [10, 13].
+Bucket getGridBucket() {
+  Bucket bucket("u#_v#_x#.####.exr");
+  bucket.columns.resize(4);
+  for (Index u = 1; u <= 3; ++u) {
+    for (Index v = 1; v <= 2; ++v) {
+      for (Index frame = 10; frame <= 13; ++frame) {
+        bucket.columns[0].push_back(u);
+        bucket.columns[1].push_back(v);
+        bucket.columns[2].push_back(7);
+        bucket.columns[3].push_back(frame);
+      }
+    }
+  }
+  return bucket;
+}
+
+TEST(splitAll, detectGrids) {
+  Buckets buckets = asVector(getGridBucket());
+  auto results = splitAllAndSort(RETAIN_HIGHEST_VARIANCE,
+                                       std::move(buckets), true);
+  ASSERT_EQ(results.size(), 1U);
+  EXPECT_EQ(results[0].pattern, "u#_v#_x7.####.exr");
+  EXPECT_EQ(results[0].extents, Ranges({{1, 3}, {1, 2}, {10, 13}}));
+  Items items;
+  results[0].output(true, [&](Item item) {
+    items.push_back(std::move(item));
+  });
+  EXPECT_EQ(items, Items({createGrid("u#_v#_x7.####.exr",
+                                     {{1, 3}, {1, 2}, {10, 13}})}));
+  // Grids are not detected unless asked.
+  EXPECT_EQ(splitAndSort(RETAIN_HIGHEST_VARIANCE, getGridBucket()).size(), 6U);
+}
+
+TEST(retainFewestItems, constantColumn) {
+  // The constant x7 location is split first.
+  EXPECT_EQ(retainFewestItems(getGridBucket()), 2U);
+}
+
+TEST(splitAll, retainFewestItemsIndependent) {
+  // Independent locations keep the same one as the default strategy.
+  const auto expected =
+      splitAndSort(RETAIN_HIGHEST_VARIANCE, getGridBucket());
+  const auto results = splitAndSort(RETAIN_FEWEST_ITEMS, getGridBucket());
+  ASSERT_EQ(results.size(), expected.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    EXPECT_EQ(results[i].pattern, expected[i].pattern);
+    EXPECT_EQ(results[i].sortedIndices, expected[i].sortedIndices);
+  }
+}
+
+TEST(getGrid, missingOrRepeatedCombination) {
+  SplitBucket grid;
+  EXPECT_TRUE(getGrid(getGridBucket(), grid));
+  Bucket bucket = getGridBucket();
+  for (auto &column : bucket.columns)
+    column.pop_back();
+  EXPECT_FALSE(getGrid(bucket, grid));
+  // Same count with a repeated combination.
+  bucket = getGridBucket();
+  for (auto &column : bucket.columns)
+    column.back() = column.front();
+  EXPECT_FALSE(getGrid(bucket, grid));
+  // A single varying column is a regular sequence.
+  bucket = Bucket("v#.####.exr");
+  bucket.columns = {Indices({1, 1}), Indices({1, 2})};
+  EXPECT_FALSE(getGrid(bucket, grid));
+}
+
 TEST(SplitBucket, outputSingleMultiplePlaceholder) {
   Bucket bucket("a#b####c");
   bucket.columns.push_back({1});
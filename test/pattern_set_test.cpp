@@ -0,0 +1,88 @@
+#include "sequence/PatternSet.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace sequence {
+
+typedef std::vector<size_t> Matched;
+
+TEST(PatternSet, empty) {
+  const PatternSet set;
+  Matched matched{1};
+  set.match("file.#.exr", matched);
+  EXPECT_TRUE(matched.empty());
+  EXPECT_FALSE(set.matchAny("file.#.exr"));
+}
+
+TEST(PatternSet, invalid) {
+  EXPECT_THROW(PatternSet({"*.####.exr", "no_padding"}), std::invalid_argument);
+}
+
+TEST(PatternSet, match) {
+  const PatternSet set({"*.####.exr", "*_comp_v@.*", "plate.@.dpx", "@*"});
+  Matched matched;
+  set.match("shot_comp_v#.####.exr", matched);
+  EXPECT_EQ(matched, Matched({0, 1}));
+  set.match("plate.#.dpx", matched);
+  EXPECT_EQ(matched, Matched({2}));
+  set.match("#plate.#.dpx", matched);
+  EXPECT_EQ(matched, Matched({3}));
+  set.match("shot.###.exr", matched);
+  EXPECT_TRUE(matched.empty());
+  EXPECT_FALSE(set.matchAny("shot.###.exr"));
+  set.match(Item("a_comp_v#.jpg"), matched);
+  EXPECT_EQ(matched, Matched({1}));
+}
+
+TEST(PatternSet, sharedLiterals) {
+  // Literals being suffixes or infixes of each other.
+  const PatternSet set({"*abc@", "*bc@", "*c@", "*abcd@", "*xabc*@"});
+  Matched matched;
+  set.match("xabcd#", matched);
+  EXPECT_EQ(matched, Matched({3, 4}));
+  set.match("zabc#", matched);
+  EXPECT_EQ(matched, Matched({0, 1, 2}));
+}
+
+TEST(PatternSet, ignoreCase) {
+  const PatternSet set({"*.####.EXR", "Plate.@.*"}, true);
+  Matched matched;
+  set.match("plate.####.exr", matched);
+  EXPECT_EQ(matched, Matched({0, 1}));
+  EXPECT_FALSE(PatternSet({"*.####.EXR"}).matchAny("a.####.exr"));
+}
+
+// Compares with matching each pattern individually.
+TEST(PatternSet, sameAsMatchers) {
+  std::srand(0);
+  const auto randomString = [](size_t maxSize, const char *characters) {
+    std::string output;
+    const size_t size = std::rand() % (maxSize + 1);
+    for (size_t i = 0; i < size; ++i)
+      output += characters[std::rand() % strlen(characters)];
+    return output;
+  };
+  std::vector<std::string> patterns;
+  for (int i = 0; i < 200; ++i)
+    patterns.push_back(randomString(4, "ab*") + "#" + randomString(4, "ab*"));
+  const PatternSet set(patterns);
+  Matched matched;
+  for (int test = 0; test < 2000; ++test) {
+    const std::string candidate =
+        randomString(6, "ab") + "#" + randomString(6, "ab");
+    Matched expected;
+    for (size_t i = 0; i < patterns.size(); ++i)
+      if (Matcher(patterns[i])(candidate))
+        expected.push_back(i);
+    set.match(candidate, matched);
+    EXPECT_EQ(matched, expected) << candidate;
+    EXPECT_EQ(set.matchAny(candidate), !expected.empty());
+  }
+}
+
+} // namespace sequence
@@ -0,0 +1,122 @@
+#include "sequence/SequenceIndex.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <set>
+
+#include <gtest/gtest.h>
+
+#include <sequence/Tools.hpp>
+
+namespace sequence {
+
+namespace {
+
+Items parseSorted(const Configuration &configuration,
+                  const std::set<std::string> &filenames) {
+  auto itr = filenames.begin();
+  std::string tmp;
+  Items items = parse(configuration, [&](FilesystemEntry &entry) {
+                  if (itr == filenames.end())
+                    return false;
+                  tmp = *itr++;
+                  entry.filename = tmp;
+                  entry.isDirectory = false;
+                  return true;
+                }).files;
+  std::sort(items.begin(), items.end());
+  return items;
+}
+
+} // namespace
+
+TEST(SequenceIndex, addRemove) {
+  SequenceIndex index(Configuration{});
+  EXPECT_TRUE(index.add("file1.jpg"));
+  EXPECT_FALSE(index.add("file1.jpg"));
+  EXPECT_TRUE(index.add("file2.jpg"));
+  EXPECT_EQ(index.size(), 2);
+  EXPECT_TRUE(index.contains("file2.jpg"));
+  EXPECT_FALSE(index.contains("file3.jpg"));
+  EXPECT_EQ(index.snapshot(), Items({createSequence("file#.jpg", {1, 2})}));
+  EXPECT_TRUE(index.remove("file1.jpg"));
+  EXPECT_FALSE(index.remove("file1.jpg"));
+  EXPECT_FALSE(index.remove("other.jpg"));
+  EXPECT_EQ(index.snapshot(), Items({createSingleFile("file2.jpg")}));
+  EXPECT_TRUE(index.remove("file2.jpg"));
+  EXPECT_EQ(index.snapshot(), Items());
+  EXPECT_EQ(index.size(), 0);
+}
+
+TEST(SequenceIndex, splitAndJoinRanges) {
+  Configuration configuration;
+  configuration.pack = true;
+  SequenceIndex index(configuration);
+  for (const char *filename : {"f1.jpg", "f2.jpg", "f3.jpg", "f4.jpg"})
+    index.add(filename);
+  EXPECT_EQ(index.snapshot(), Items({createSequence("f#.jpg", 1, 4)}));
+  index.remove("f2.jpg");
+  EXPECT_EQ(index.snapshot(), Items({createSequence("f#.jpg", 1, 1),
+                                     createSequence("f#.jpg", 3, 4)}));
+  index.add("f2.jpg");
+  EXPECT_EQ(index.snapshot(), Items({createSequence("f#.jpg", 1, 4)}));
+}
+
+TEST(SequenceIndex, patternLikeFile) {
+  SequenceIndex index(Configuration{});
+  index.add("file####.ext");
+  index.add("file0001.ext");
+  EXPECT_TRUE(index.contains("file####.ext"));
+  EXPECT_TRUE(index.remove("file0001.ext"));
+  EXPECT_TRUE(index.contains("file####.ext"));
+}
+
+TEST(SequenceIndex, update) {
+  SequenceIndex index(Configuration{});
+  index.add("a1.jpg");
+  index.add("b1.jpg");
+  index.snapshot();
+  index.add("a2.jpg");
+  size_t calls = 0;
+  index.update([&calls](const Items &removed, const Items &added) {
+    ++calls;
+    EXPECT_EQ(removed, Items({createSingleFile("a1.jpg")}));
+    EXPECT_EQ(added, Items({createSequence("a#.jpg", {1, 2})}));
+  });
+  EXPECT_EQ(calls, 1);
+}
+
+// Random insertions and deletions must match a full parse.
+TEST(SequenceIndex, matchesParse) {
+  std::mt19937 generator(42);
+  const char *formats[] = {"shot_%02u.exr", "shot_%03u.exr", "tile_%u_%u.exr",
+                           "frame%u.dpx", "readme"};
+  for (const bool pack : {false, true}) {
+    for (const bool mergePadding : {false, true}) {
+      Configuration configuration;
+      configuration.pack = pack;
+      configuration.mergePadding = mergePadding;
+      SequenceIndex index(configuration);
+      std::set<std::string> filenames;
+      char buffer[64];
+      for (int i = 0; i < 2000; ++i) {
+        const char *format = formats[generator() % 5];
+        snprintf(buffer, sizeof(buffer), format, unsigned(generator() % 150),
+                 unsigned(generator() % 3));
+        if (generator() % 3 == 0) {
+          EXPECT_EQ(index.remove(buffer), filenames.erase(buffer) == 1);
+        } else {
+          EXPECT_EQ(index.add(buffer), filenames.insert(buffer).second);
+        }
+        if (i % 100 == 0) {
+          ASSERT_EQ(index.snapshot(), parseSorted(configuration, filenames));
+        }
+      }
+      EXPECT_EQ(index.size(), filenames.size());
+      ASSERT_EQ(index.snapshot(), parseSorted(configuration, filenames));
+    }
+  }
+}
+
+} // namespace sequence
@@ -0,0 +1,104 @@
+#include "sequence/Stats.hpp"
+
+#include <cstdio>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <sequence/Parser.hpp>
+#include <sequence/Tools.hpp>
+
+#include "TemporaryFolder.hpp"
+
+namespace sequence {
+
+TEST(ItemStats, addAndMerge) {
+  ItemStats a, b;
+  a.add(1, 100, 10);
+  a.add(2, 50, 30);
+  b.add(3, 100, 20);
+  b.add(4, 0, 5);
+  ++b.missing;
+  EXPECT_EQ(1U, a.largestFrame);
+  EXPECT_EQ(2U, a.smallestFrame);
+  a.merge(b);
+  EXPECT_EQ(250U, a.bytes);
+  EXPECT_EQ(5, a.minMtime);
+  EXPECT_EQ(30, a.maxMtime);
+  EXPECT_EQ(4U, a.smallestFrame);
+  EXPECT_EQ(0U, a.smallestSize);
+  EXPECT_EQ(1U, a.largestFrame); // first largest wins
+  EXPECT_EQ(100U, a.largestSize);
+  EXPECT_EQ(4U, a.files);
+  EXPECT_EQ(1U, a.missing);
+}
+
+#if defined(__linux) || defined(__APPLE__)
+
+TEST(ItemStats, parseDir) {
+  TemporaryFolder folder;
+  for (int frame = 1; frame <= 3000; ++frame) {
+    char filename[16];
+    snprintf(filename, sizeof(filename), "shot.%04d.exr", frame);
+    const size_t size = frame == 1500 ? 1 : 10 + frame % 2;
+    folder.write(filename, std::string(size, 'x'));
+  }
+  folder.write("readme", "12345");
+  Configuration configuration;
+  configuration.pack = true;
+  configuration.sort = true;
+  configuration.gatherStats = true;
+  const auto content = parseDir(configuration, folder.path);
+  ASSERT_EQ(Items({createSingleFile("readme"),
+                   createSequence("shot.####.exr", 1, 3000)}),
+            content.files);
+  ASSERT_EQ(2U, content.stats.size());
+  EXPECT_EQ(5U, content.stats[0].bytes);
+  EXPECT_EQ(1U, content.stats[0].files);
+  const ItemStats &sequence = content.stats[1];
+  EXPECT_EQ(3000U, sequence.files);
+  EXPECT_EQ(0U, sequence.missing);
+  EXPECT_EQ(1U + 1499 * 10 + 1500 * 11, sequence.bytes);
+  EXPECT_EQ(1500U, sequence.smallestFrame);
+  EXPECT_EQ(1U, sequence.largestFrame);
+  EXPECT_LE(sequence.minMtime, sequence.maxMtime);
+}
+
+TEST(ItemStats, missingFiles) {
+  TemporaryFolder folder;
+  folder.write("f1.exr", "123");
+  const auto stats = getItemsStats(
+      folder.path, {createSequence("f#.exr", {1, 2}), createSingleFile("g")});
+  ASSERT_EQ(2U, stats.size());
+  EXPECT_EQ(3U, stats[0].bytes);
+  EXPECT_EQ(1U, stats[0].missing);
+  EXPECT_EQ(1U, stats[1].missing);
+  EXPECT_TRUE(getItemsStats(folder.path + "/missing", {}).empty());
+}
+
+TEST(ItemStats, indicedBatches) {
+  // Frames of an INDICED Item span several batches.
+  TemporaryFolder folder;
+  Indices indices;
+  for (Index frame = 1; frame < 4400; frame += 2) {
+    indices.push_back(frame);
+    if (frame == 4001)
+      continue;
+    char filename[16];
+    snprintf(filename, sizeof(filename), "f%d.exr", frame);
+    const size_t size = frame == 2101 ? 1 : frame == 3001 ? 20 : 10;
+    folder.write(filename, std::string(size, 'x'));
+  }
+  const auto stats =
+      getItemsStats(folder.path, {createSequence("f#.exr", indices)});
+  ASSERT_EQ(1U, stats.size());
+  EXPECT_EQ(indices.size() - 1, stats[0].files);
+  EXPECT_EQ(1U, stats[0].missing);
+  EXPECT_EQ(1U + 20 + (indices.size() - 3) * 10, stats[0].bytes);
+  EXPECT_EQ(2101U, stats[0].smallestFrame);
+  EXPECT_EQ(3001U, stats[0].largestFrame);
+}
+
+#endif
+
+} // namespace sequence
@@ -1,5 +1,6 @@
 #include "sequence/Tools.hpp"
 
+#include <cstdlib>
 #include <iostream>
 #include <utility>
 
@@ -82,6 +83,15 @@ TEST(Tools, createInvalidSequence) {
   EXPECT_EQ(createSequence("#", 0, 0, 0).getType(), Item::INVALID);
 }
 
+TEST(Tools, createGrid) {
+  const Item item = createGrid("u#_v#.####.exr", {{1, 4}, {1, 2}, {10, 20}});
+  EXPECT_EQ(item.getType(), Item::GRID);
+  EXPECT_EQ(item.extents, Item::Extents({{1, 4}, {1, 2}, {10, 20}}));
+  EXPECT_THROW(createGrid("u#.exr", {{1, 4}, {1, 2}}), std::invalid_argument);
+  EXPECT_THROW(createGrid("u#_v#.exr", {{4, 1}, {1, 2}}),
+               std::invalid_argument);
+}
+
 TEST(Tools, createSequenceFilename) {
   EXPECT_EQ(createSequence("file-#.png", 0, 0).filename, "file-#.png");
   EXPECT_EQ(createSequence("file-###.png", 0, 0).filename, "file-###.png");
@@ -89,6 +99,65 @@ TEST(Tools, createSequenceFilename) {
   EXPECT_EQ(createSequence("file-#-.cr2", 0, 0).filename, "file-#-.cr2");
 }
 
+TEST(Tools, formatFrameSpec) {
+  EXPECT_EQ(formatFrameSpec({}), "");
+  EXPECT_EQ(formatFrameSpec({5}), "5");
+  EXPECT_EQ(formatFrameSpec({5, 6}), "5,6");
+  EXPECT_EQ(formatFrameSpec({1, 2, 3}), "1-3");
+  EXPECT_EQ(formatFrameSpec({1, 2, 3, 5, 7, 9, 10}), "1-3,5-9x2,10");
+  EXPECT_EQ(formatFrameSpec({1, 3, 4, 5, 6}), "1,3-6");
+  EXPECT_EQ(formatFrameSpec({0, 4294967295}), "0,4294967295");
+  EXPECT_EQ(formatFrameSpec({0, 1, 2, 9, 10, 11}), "0-2,9-11");
+  // A greedy encoding would give "1-5x2,6,7".
+  EXPECT_EQ(formatFrameSpec({1, 3, 5, 6, 7}), "1,3,5-7");
+  EXPECT_EQ(formatFrameSpec({1, 2, 3, 4, 6, 8, 10}), "1-4,6-10x2");
+}
+
+TEST(Tools, formatFrameRanges) {
+  EXPECT_EQ(formatFrameRanges(FrameRanges()), "");
+  EXPECT_EQ(formatFrameRanges(FrameRanges{{1, 1}}), "1");
+  EXPECT_EQ(formatFrameRanges(FrameRanges{{1, 2}}), "1,2");
+  EXPECT_EQ(formatFrameRanges(FrameRanges{{1, 5, 4}}), "1,5");
+  EXPECT_EQ(formatFrameRanges(FrameRanges{{1, 10}, {20, 30, 2}}),
+            "1-10,20-30x2");
+  EXPECT_EQ(formatFrameRanges(FrameRanges{{1, 11, 3}}), "1-10x3");
+}
+
+TEST(Tools, parseFrameSpec) {
+  EXPECT_EQ(parseFrameSpec(""), Indices());
+  EXPECT_EQ(parseFrameSpec("5"), Indices({5}));
+  EXPECT_EQ(parseFrameSpec("1-3,5-9x2,10"), Indices({1, 2, 3, 5, 7, 9, 10}));
+  EXPECT_EQ(parseFrameSpec("1-10x4"), Indices({1, 5, 9}));
+  EXPECT_EQ(parseFrameSpec("4294967294-4294967295"),
+            Indices({4294967294, 4294967295}));
+  EXPECT_EQ(parseFrameRanges("1-3,5-9x2,10"),
+            FrameRanges({{1, 3}, {5, 9, 2}, {10, 10}}));
+  EXPECT_THROW(parseFrameSpec(","), std::invalid_argument);
+  EXPECT_THROW(parseFrameSpec("1,"), std::invalid_argument);
+  EXPECT_THROW(parseFrameSpec("1-"), std::invalid_argument);
+  EXPECT_THROW(parseFrameSpec("1-5x"), std::invalid_argument);
+  EXPECT_THROW(parseFrameSpec("1-5x0"), std::invalid_argument);
+  EXPECT_THROW(parseFrameSpec("5-1"), std::invalid_argument);
+  EXPECT_THROW(parseFrameSpec("1 2"), std::invalid_argument);
+  EXPECT_THROW(parseFrameSpec("-1"), std::invalid_argument);
+  EXPECT_THROW(parseFrameSpec("4294967296"), std::invalid_argument);
+}
+
+TEST(Tools, frameSpecRoundTrip) {
+  std::srand(0);
+  for (int test = 0; test < 100; ++test) {
+    Indices indices;
+    Index frame = 0;
+    for (int i = 0; i < 50; ++i) {
+      frame += 1 + std::rand() % 3;
+      indices.push_back(frame);
+    }
+    const std::string spec = formatFrameSpec(indices);
+    EXPECT_EQ(parseFrameSpec(spec), indices) << spec;
+    EXPECT_EQ(formatFrameRanges(parseFrameRanges(spec)), spec);
+  }
+}
+
 TEST(Tools, matcherItem) {
   EXPECT_EQ(details::getMatcherString("@"), "#+");
   EXPECT_EQ(details::getMatcherString("file###.jpg"), "file###\\.jpg");
@@ -114,7 +183,7 @@ TEST(Tools, match) {
 TEST(Tools, filter) {
   Items items = {createSequence("file-#.png", 1, 2),
                  createSequence("file-#.jpg", 1, 2)};
-  const std::regex matcher = getMatcher("file-@.png");
+  const Matcher matcher = getMatcher("file-@.png");
   auto predicate = [&](const Item &item) -> bool {
     return !match(matcher, item);
   };
@@ -217,6 +217,72 @@ TEST(Bucket, splitLinear) {
   }
 }
 
+Bucket ingestAll(std::initializer_list<Index> indices) {
+  Bucket bucket("a#b");
+  for (const Index index : indices)
+    bucket.ingest(index);
+  return bucket;
+}
+
+TEST(Bucket, ingestRanges) {
+  const auto bucket = ingestAll({1, 2, 3, 5, 6});
+  EXPECT_EQ(bucket.ranges, (Ranges{{1, 3}, {5, 6}}));
+  EXPECT_EQ(bucket.step, 1);
+  EXPECT_EQ(bucket.columns[0], Indices());
+}
+
+TEST(Bucket, ingestRangesStep) {
+  const auto bucket = ingestAll({10, 12, 14, 20});
+  EXPECT_EQ(bucket.ranges, (Ranges{{10, 14}, {20, 20}}));
+  EXPECT_EQ(bucket.step, 2);
+}
+
+TEST(Bucket, ingestRangesOutOfOrder) {
+  const auto bucket = ingestAll({5, 6, 1, 8, 3, 2, 7, 4});
+  EXPECT_EQ(bucket.ranges, (Ranges{{1, 8}}));
+  EXPECT_EQ(bucket.columns[0], Indices());
+}
+
+TEST(Bucket, ingestRangesStepBreak) {
+  const auto bucket = ingestAll({2, 4, 6, 7});
+  EXPECT_EQ(bucket.ranges, Ranges());
+  EXPECT_EQ(bucket.step, 0);
+  EXPECT_EQ(bucket.columns[0], Indices({2, 4, 6, 7}));
+}
+
+TEST(Bucket, ingestRangesDecreasing) {
+  const auto bucket = ingestAll({3, 2, 1});
+  EXPECT_EQ(bucket.ranges, Ranges());
+  EXPECT_EQ(bucket.columns[0], Indices({3, 2, 1}));
+}
+
+TEST(Bucket, ingestRangesSingle) {
+  const auto bucket = ingestAll({3});
+  EXPECT_TRUE(bucket.single());
+  EXPECT_EQ(bucket.columns[0], Indices({3}));
+}
+
+TEST(Bucket, ingestRangesPoorCompression) {
+  Bucket bucket("a#b");
+  for (Index i = 0; i < 100; ++i)
+    bucket.ingest(i * 4);
+  bucket.ingest(1);
+  for (Index i = 0; i < 100; ++i)
+    bucket.ingest(i * 4 + 2);
+  EXPECT_EQ(bucket.ranges, Ranges());
+  EXPECT_EQ(bucket.columns[0].size(), 201);
+}
+
+TEST(SplitBucket, unpack) {
+  SplitBucket bucket(ingestAll({1, 3, 5, 9}));
+  EXPECT_EQ(bucket.ranges, (Ranges{{1, 5}, {9, 9}}));
+  bucket.pack();
+  EXPECT_EQ(bucket.ranges, (Ranges{{1, 5}, {9, 9}}));
+  bucket.unpack();
+  EXPECT_EQ(bucket.ranges, Ranges());
+  EXPECT_EQ(bucket.sortedIndices, Indices({1, 3, 5, 9}));
+}
+
 TEST(SplitBucket, step) {
   EXPECT_EQ(getStep({1, 2, 3}), 1);
   EXPECT_EQ(getStep({2, 4, 6, 22, 24}), 2);
@@ -0,0 +1,106 @@
+#include "sequence/Verification.hpp"
+
+#include <gtest/gtest.h>
+
+#include "TemporaryFolder.hpp"
+
+namespace sequence {
+
+namespace {
+
+GetNextEntryFunction getEntries(std::vector<std::string> &filenames) {
+  auto itr = filenames.begin();
+  return [&filenames, itr](FilesystemEntry &entry) mutable {
+    if (itr == filenames.end())
+      return false;
+    entry.filename = *itr++;
+    entry.isDirectory = false;
+    return true;
+  };
+}
+
+} // namespace
+
+TEST(Verification, complete) {
+  std::vector<std::string> filenames = {"shot.1003.exr", "shot.1001.exr",
+                                        "shot.1002.exr", "other.txt"};
+  const auto result =
+      verifyEntries("shot.####.exr", FrameRange(1001, 1003),
+                    getEntries(filenames));
+  EXPECT_TRUE(result.complete());
+  EXPECT_TRUE(result.extra.empty());
+}
+
+TEST(Verification, missingAndExtra) {
+  std::vector<std::string> filenames;
+  for (Index frame = 1; frame <= 200; ++frame)
+    if (frame != 70 && frame != 71 && frame != 130)
+      filenames.push_back("shot." + std::to_string(frame + 1000) + ".exr");
+  filenames.push_back("shot.0999.exr");
+  filenames.push_back("shot.1300.exr");
+  filenames.push_back("shot.1301.exr");
+  const auto result = verifyEntries("shot.####.exr", FrameRange(1001, 1200),
+                                    getEntries(filenames));
+  EXPECT_FALSE(result.complete());
+  EXPECT_EQ(FrameRanges({{1070, 1071}, {1130, 1130}}), result.missing);
+  EXPECT_EQ(FrameRanges({{999, 999}, {1300, 1301}}), result.extra);
+}
+
+TEST(Verification, step) {
+  std::vector<std::string> filenames = {"f1.exr", "f3.exr", "f4.exr",
+                                        "f9.exr"};
+  const auto result =
+      verifyEntries("f#.exr", FrameRange(1, 9, 2), getEntries(filenames));
+  EXPECT_EQ(FrameRanges({{5, 7, 2}}), result.missing);
+  EXPECT_EQ(FrameRanges({{4, 4}}), result.extra);
+}
+
+TEST(Verification, padding) {
+  std::vector<std::string> filenames = {"f001.exr", "f01.exr", "f0002.exr",
+                                        "f1000.exr", "f1a1.exr", "f.exr",
+                                        "f99999999999.exr"};
+  const auto result =
+      verifyEntries("f###.exr", FrameRange(1, 2), getEntries(filenames));
+  EXPECT_EQ(FrameRanges({{2, 2}}), result.missing);
+  EXPECT_EQ(FrameRanges({{1000, 1000}}), result.extra);
+}
+
+TEST(Verification, directories) {
+  std::vector<std::string> filenames = {"f1.exr"};
+  auto getNextEntry = getEntries(filenames);
+  const auto result =
+      verifyEntries("f#.exr", FrameRange(1, 1),
+                    [&getNextEntry](FilesystemEntry &entry) {
+                      const bool next = getNextEntry(entry);
+                      entry.isDirectory = true;
+                      return next;
+                    });
+  EXPECT_EQ(FrameRanges({{1, 1}}), result.missing);
+}
+
+TEST(Verification, invalid) {
+  std::vector<std::string> filenames;
+  EXPECT_THROW(verifyEntries("f.exr", FrameRange(1, 2), getEntries(filenames)),
+               std::invalid_argument);
+  EXPECT_THROW(verifyEntries("f#.exr", FrameRange(2, 1), getEntries(filenames)),
+               std::invalid_argument);
+  Verification result;
+  EXPECT_FALSE(verifySequence("/does/not/exist/f#.exr", FrameRange(1, 2),
+                              result));
+}
+
+#if defined(__linux)
+TEST(Verification, directory) {
+  TemporaryFolder folder;
+  const std::string &path = folder.path;
+  for (const char *filename : {"shot.1001.exr", "shot.1003.exr", "shot.exr"})
+    folder.touch(filename);
+  Verification result;
+  ASSERT_TRUE(
+      verifySequence(path + "/shot.####.exr", FrameRange(1001, 1003), result));
+  EXPECT_EQ(FrameRanges({{1002, 1002}}), result.missing);
+  EXPECT_TRUE(result.extra.empty());
+}
+#endif
+
+} // namespace sequence
@@ -0,0 +1,146 @@
+#include "sequence/Watcher.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+#include <sys/stat.h>
+
+#include <gtest/gtest.h>
+
+#include <sequence/Tools.hpp>
+
+#include "TemporaryFolder.hpp"
+
+namespace sequence {
+
+#if defined(__linux)
+
+namespace {
+
+std::vector<SequenceChange> poll(Watcher &watcher) {
+  std::vector<SequenceChange> changes;
+  watcher.poll(1000, [&changes](const SequenceChange &change) {
+    changes.push_back(change);
+  });
+  return changes;
+}
+
+} // namespace
+
+TEST(Watcher, initialContent) {
+  TemporaryFolder folder;
+  folder.touch("file1.jpg");
+  folder.touch("file2.jpg");
+  folder.touch("readme");
+  Configuration configuration;
+  configuration.pack = true;
+  Watcher watcher(configuration);
+  ASSERT_TRUE(watcher.watch(folder.path));
+  EXPECT_FALSE(watcher.watch(folder.path + "/missing"));
+  EXPECT_EQ(watcher.snapshot(folder.path).files,
+            Items({createSingleFile("readme"),
+                   createSequence("file#.jpg", 1, 2)}));
+}
+
+TEST(Watcher, createDeleteRename) {
+  TemporaryFolder folder;
+  folder.touch("file1.jpg");
+  folder.touch("file2.jpg");
+  Configuration configuration;
+  configuration.pack = true;
+  Watcher watcher(configuration);
+  ASSERT_TRUE(watcher.watch(folder.path));
+
+  folder.touch("file3.jpg");
+  auto changes = poll(watcher);
+  ASSERT_EQ(changes.size(), 1);
+  EXPECT_EQ(changes[0].folder, folder.path);
+  EXPECT_EQ(changes[0].removed, Items({createSequence("file#.jpg", 1, 2)}));
+  EXPECT_EQ(changes[0].added, Items({createSequence("file#.jpg", 1, 3)}));
+
+  ASSERT_EQ(std::remove(folder.get("file1.jpg").c_str()), 0);
+  changes = poll(watcher);
+  ASSERT_EQ(changes.size(), 1);
+  EXPECT_EQ(changes[0].added, Items({createSequence("file#.jpg", 2, 3)}));
+
+  ASSERT_EQ(std::rename(folder.get("file3.jpg").c_str(),
+                        folder.get("other.jpg").c_str()),
+            0);
+  changes = poll(watcher);
+  ASSERT_EQ(changes.size(), 1);
+  EXPECT_EQ(changes[0].removed, Items({createSequence("file#.jpg", 2, 3)}));
+  EXPECT_EQ(changes[0].added, Items({createSingleFile("file2.jpg"),
+                                     createSingleFile("other.jpg")}));
+  EXPECT_EQ(watcher.snapshot(folder.path).files,
+            Items({createSingleFile("file2.jpg"),
+                   createSingleFile("other.jpg")}));
+}
+
+TEST(Watcher, recursive) {
+  TemporaryFolder folder;
+  Configuration configuration;
+  configuration.pack = true;
+  Watcher watcher(configuration);
+  ASSERT_TRUE(watcher.watch(folder.path, true));
+  ASSERT_EQ(mkdir(folder.get("shot").c_str(), 0755), 0);
+  folder.touch("shot/file1.jpg");
+  ASSERT_EQ(mkdir(folder.get("shot/nested").c_str(), 0755), 0);
+  poll(watcher);
+  folder.touch("shot/nested/file1.jpg");
+  folder.touch("shot/nested/file2.jpg");
+  poll(watcher);
+  EXPECT_EQ(watcher.snapshot(folder.get("shot")).files,
+            Items({createSingleFile("file1.jpg")}));
+  EXPECT_EQ(watcher.snapshot(folder.get("shot/nested")).files,
+            Items({createSequence("file#.jpg", 1, 2)}));
+  // Without recursion created folders are not watched.
+  TemporaryFolder other;
+  Watcher flat(configuration);
+  ASSERT_TRUE(flat.watch(other.path));
+  ASSERT_EQ(mkdir(other.get("shot").c_str(), 0755), 0);
+  poll(flat);
+  EXPECT_EQ(flat.snapshot(other.get("shot")).name, "");
+}
+
+TEST(Watcher, grid) {
+  TemporaryFolder folder;
+  for (int u = 1; u <= 2; ++u)
+    for (int v = 1; v <= 2; ++v)
+      for (int frame = 1; frame <= 3; ++frame)
+        folder.touch("u" + std::to_string(u) + "_v" + std::to_string(v) + "." +
+                     std::to_string(frame) + ".exr");
+  Configuration configuration;
+  configuration.pack = true;
+  configuration.sort = true;
+  configuration.detectGrids = true;
+  Watcher watcher(configuration);
+  ASSERT_TRUE(watcher.watch(folder.path));
+  const Item grid = createGrid("u#_v#.#.exr", {{1, 2}, {1, 2}, {1, 3}});
+  EXPECT_EQ(watcher.snapshot(folder.path).files, Items({grid}));
+
+  // Changes are reported as the directory would be listed.
+  ASSERT_EQ(std::remove(folder.get("u2_v2.3.exr").c_str()), 0);
+  auto changes = poll(watcher);
+  ASSERT_EQ(changes.size(), 1);
+  EXPECT_EQ(changes[0].removed, Items({grid}));
+  Items listed = parseDir(configuration, folder.path).files;
+  std::sort(listed.begin(), listed.end());
+  EXPECT_EQ(changes[0].added, listed);
+
+  folder.touch("u2_v2.3.exr");
+  changes = poll(watcher);
+  ASSERT_EQ(changes.size(), 1);
+  EXPECT_EQ(changes[0].added, Items({grid}));
+}
+
+TEST(Watcher, noEvent) {
+  TemporaryFolder folder;
+  Watcher watcher(Configuration{});
+  ASSERT_TRUE(watcher.watch(folder.path));
+  EXPECT_EQ(watcher.poll(0, [](const SequenceChange &) {}), 0);
+}
+
+#endif
+
+} // namespace sequence